@@ -1,10 +1,17 @@
 #pragma once
 
 #include <atomic>
+#include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <iterator>
 #include <utility>
 #include <memory>
 #include <stdexcept>
+#include <vector>
+
+#include "spscq_config.hpp"
+#include "spscq_policies.hpp"
 
 /**
  * @brief A lock-free Single-Producer Single-Consumer (SPSC) queue implementation.
@@ -20,16 +27,34 @@
  * - In-place construction of elements
  * - Exception-safe operations
  *
+ * The queue is configured by policies (see spscq_policies.hpp), all resolved at
+ * compile time. The defaults reproduce the unconfigured queue.
+ *
  * @tparam T The type of elements stored in the queue
- * @tparam Allocator The allocator type used for memory management, defaults to std::allocator<T>
+ * @tparam Storage Storage policy owning the buffer, or an allocator type selecting
+ *         heap_storage with that allocator; defaults to std::allocator<T>
+ * @tparam Indexing Index wrapping policy: wrap_indexing (default) or mask_indexing
+ * @tparam Publication Write index publication policy: eager_publication (default)
+ *         or batched_publication<N>
+ * @tparam Wait Waiting policy of the blocking operations, defaults to spin_wait
+ * @tparam Stats Statistics policy, defaults to no_stats
+ * @tparam Layout Index layout policy: padded_layout (default) or dense_layout
  *
  * @note This queue is designed for single-producer single-consumer scenarios only.
  *       Using multiple producers or consumers will result in undefined behavior.
  */
-template <typename T, typename Allocator = std::allocator<T>>
+template <typename T,
+          typename Storage = std::allocator<T>,
+          typename Indexing = wrap_indexing,
+          typename Publication = eager_publication,
+          typename Wait = spin_wait,
+          typename Stats = no_stats,
+          typename Layout = padded_layout>
 class spscq
 {
 public:
+    using storage_type = typename spscq_detail::storage_for<T, Storage>::type;
+
     /**
      * @brief Attempts to construct an element in-place at the back of the queue.
      *
@@ -49,21 +74,51 @@ public:
     {
         static_assert(std::is_constructible_v<T, Args...>, "The type T must support construction with the provided arguments.");
 
-        const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
-        const size_t nextWriteIdx = increment(writeIdx);
-
-        if (nextWriteIdx == readIdxCached_)
+        if constexpr (batched)
         {
-            readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+            const size_t writeIdx = writeIdxPending_;
+            const size_t nextWriteIdx = increment(writeIdx);
+
             if (nextWriteIdx == readIdxCached_)
             {
-                return false;
+                readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+                if (nextWriteIdx == readIdxCached_)
+                {
+                    // Let the consumer see what is pending so it can free slots
+                    publish_pending();
+                    producerStats_.on_full();
+                    return false;
+                }
+            }
+
+            new (&data_[writeIdx]) T(std::forward<Args>(args)...);
+            writeIdxPending_ = nextWriteIdx;
+
+            if (++pendingCount_ >= Publication::batch)
+            {
+                publish_pending();
             }
         }
+        else
+        {
+            const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+            const size_t nextWriteIdx = increment(writeIdx);
 
-        new (&data_[writeIdx]) T(std::forward<Args>(args)...);
-        writeIdx_.store(nextWriteIdx, std::memory_order_release);
+            if (nextWriteIdx == readIdxCached_)
+            {
+                readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+                if (nextWriteIdx == readIdxCached_)
+                {
+                    producerStats_.on_full();
+                    return false;
+                }
+            }
+
+            new (&data_[writeIdx]) T(std::forward<Args>(args)...);
+            writeIdx_.store(nextWriteIdx, std::memory_order_release);
+        }
 
+        producerStats_.on_push(1);
         return true;
     }
 
@@ -86,6 +141,62 @@ public:
         return try_emplace(std::forward<P>(value));
     }
 
+    /**
+     * @brief Constructs an element in-place at the back of the queue, waiting for space.
+     *
+     * Retries try_emplace, calling the producer's wait policy between attempts.
+     *
+     * @tparam Args Parameter pack of argument types for element construction
+     * @param args Arguments forwarded to the element's constructor
+     *
+     * @note Must only be called from the producer thread
+     */
+    template <typename... Args>
+    void emplace(Args &&...args)
+    {
+        while (!try_emplace(std::forward<Args>(args)...))
+        {
+            producerStats_.on_wait();
+            producerWait_.wait();
+        }
+        producerWait_.reset();
+    }
+
+    /**
+     * @brief Adds an element to the back of the queue, waiting for space.
+     *
+     * @tparam P Type of the value to push (typically deduced)
+     * @param value Value to push into the queue
+     *
+     * @note Must only be called from the producer thread
+     */
+    template <typename P>
+    void push(P &&value)
+    {
+        while (!try_push(std::forward<P>(value)))
+        {
+            producerStats_.on_wait();
+            producerWait_.wait();
+        }
+        producerWait_.reset();
+    }
+
+    /**
+     * @brief Publishes the elements pushed but not yet visible to the consumer.
+     *
+     * Only has an effect with batched_publication; eager publication makes every
+     * element visible as soon as it is pushed.
+     *
+     * @note Must only be called from the producer thread
+     */
+    void flush() noexcept
+    {
+        if constexpr (batched)
+        {
+            publish_pending();
+        }
+    }
+
     /**
      * @brief Attempts to remove and return the front element of the queue.
      *
@@ -103,6 +214,8 @@ public:
     {
         static_assert(std::is_copy_assignable_v<T>, "The type T must be copy assignable.");
 
+        assert(pendingDestroy_ == 0 && "call reclaim() after try_pop_deferred");
+
         const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
 
         if (readIdx == writeIdxCached_)
@@ -110,6 +223,7 @@ public:
             writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
             if (readIdx == writeIdxCached_)
             {
+                consumerStats_.on_empty();
                 return false;
             }
         }
@@ -120,9 +234,504 @@ public:
         const size_t nextReadIdx = increment(readIdx);
         readIdx_.store(nextReadIdx, std::memory_order_release);
 
+        consumerStats_.on_pop(1);
+        return true;
+    }
+
+    /**
+     * @brief Removes the front element of the queue, waiting for one to arrive.
+     *
+     * Retries try_pop, calling the consumer's wait policy between attempts.
+     *
+     * @param value Reference where the removed element will be stored
+     *
+     * @note Must only be called from the consumer thread
+     */
+    void pop(T &value)
+    {
+        while (!try_pop(value))
+        {
+            consumerStats_.on_wait();
+            consumerWait_.wait();
+        }
+        consumerWait_.reset();
+    }
+
+    /**
+     * @brief Attempts to move the front element out, deferring its destruction.
+     *
+     * Unlike try_pop, the moved-from element is not destroyed and its slot is not yet
+     * released to the producer: the pop path does only the move. Pending slots are
+     * destroyed and released in one batch by reclaim(), which runs automatically when
+     * the queue is found empty (the consumer is idle). When the consumer's view of the
+     * queue shows fewer than reclaimChunk free slots, each deferred pop also releases
+     * up to reclaimChunk pending slots, so a producer close to full is never starved
+     * and no single pop destroys more than reclaimChunk elements.
+     *
+     * @param value Reference where the removed element will be stored
+     * @return true if an element was successfully removed
+     * @return false if the queue was empty
+     *
+     * @note This operation is lock-free and can be safely called from the consumer thread
+     * @note Call reclaim() before any other consumer operation; they assert that no
+     *       slots are pending rather than checking on every call
+     * @note Pending slots still count towards size() until they are reclaimed
+     */
+    bool try_pop_deferred(T &value)
+    {
+        const size_t readIdx = advance(readIdx_.load(std::memory_order_relaxed), pendingDestroy_);
+
+        if (readIdx == writeIdxCached_)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+            if (readIdx == writeIdxCached_)
+            {
+                reclaim();
+                consumerStats_.on_empty();
+                return false;
+            }
+        }
+
+        value = std::move(data_[readIdx]);
+        consumerStats_.on_pop(1);
+        ++pendingDestroy_;
+
+        // Released slots are only worth their destructors once the producer may run out
+        if (used(writeIdxCached_, readIdx_.load(std::memory_order_relaxed)) + reclaimChunk > capacity())
+        {
+            release_pending(reclaimChunk);
+        }
+
         return true;
     }
 
+    /**
+     * @brief Destroys the elements popped by try_pop_deferred and releases their slots.
+     *
+     * @note Must only be called from the consumer thread, typically when it is idle
+     */
+    void reclaim() noexcept
+    {
+        release_pending(pendingDestroy_);
+    }
+
+    /**
+     * @brief Attempts to copy a block of elements to the back of the queue.
+     *
+     * Copies as many of the given elements as there is space for and publishes them
+     * all with a single store of the write index.
+     *
+     * @param values Pointer to the elements to copy
+     * @param count Number of elements to copy
+     * @return size_t Number of elements added, from 0 to count
+     *
+     * @note This operation is lock-free and can be safely called from the producer thread
+     * @note If copying an element throws, the elements copied by this call are destroyed
+     *       and none of them is added
+     */
+    size_t try_push_n(const T *values, size_t count)
+    {
+        flush();
+
+        const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+
+        size_t free = space(writeIdx, readIdxCached_);
+        if (free < count)
+        {
+            readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+            free = space(writeIdx, readIdxCached_);
+        }
+
+        const size_t n = free < count ? free : count;
+        size_t idx = writeIdx;
+
+        try
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                new (&data_[idx]) T(values[i]);
+                idx = increment(idx);
+            }
+        }
+        catch (...)
+        {
+            for (size_t i = writeIdx; i != idx; i = increment(i))
+            {
+                data_[i].~T();
+            }
+            throw;
+        }
+
+        if (n != 0)
+        {
+            writeIdx_.store(idx, std::memory_order_release);
+            if constexpr (batched)
+            {
+                // Later pushes construct from the pending index, which must follow
+                writeIdxPending_ = idx;
+            }
+            producerStats_.on_push(n);
+        }
+        else if (count != 0)
+        {
+            producerStats_.on_full();
+        }
+
+        return n;
+    }
+
+    /**
+     * @brief Attempts to move a block of elements out of the front of the queue.
+     *
+     * Moves up to maxCount elements and releases their slots with a single store of
+     * the read index.
+     *
+     * @param values Pointer to the storage receiving the elements
+     * @param maxCount Maximum number of elements to remove
+     * @return size_t Number of elements removed, from 0 to maxCount
+     *
+     * @note This operation is lock-free and can be safely called from the consumer thread
+     */
+    size_t try_pop_n(T *values, size_t maxCount)
+    {
+        assert(pendingDestroy_ == 0 && "call reclaim() after try_pop_deferred");
+
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        size_t available = used(writeIdxCached_, readIdx);
+        if (available < maxCount)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+            available = used(writeIdxCached_, readIdx);
+        }
+
+        const size_t n = available < maxCount ? available : maxCount;
+        size_t idx = readIdx;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            values[i] = std::move(data_[idx]);
+            data_[idx].~T();
+            idx = increment(idx);
+        }
+
+        if (n != 0)
+        {
+            readIdx_.store(idx, std::memory_order_release);
+            consumerStats_.on_pop(n);
+        }
+        else if (maxCount != 0)
+        {
+            consumerStats_.on_empty();
+        }
+
+        return n;
+    }
+
+    /**
+     * @brief Returns a pointer to the front element without removing it.
+     *
+     * @return T* Pointer to the front element, or nullptr if the queue is empty
+     *
+     * @note This operation is lock-free and can be safely called from the consumer thread
+     * @note The pointer stays valid until pop() is called
+     */
+    T *front() noexcept
+    {
+        assert(pendingDestroy_ == 0 && "call reclaim() after try_pop_deferred");
+
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        if (readIdx == writeIdxCached_)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+            if (readIdx == writeIdxCached_)
+            {
+                consumerStats_.on_empty();
+                return nullptr;
+            }
+        }
+
+        return &data_[readIdx];
+    }
+
+    /**
+     * @brief Removes the front element of the queue.
+     *
+     * @note Must only be called from the consumer thread after front() returned a non-null pointer
+     */
+    void pop() noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        data_[readIdx].~T();
+        readIdx_.store(increment(readIdx), std::memory_order_release);
+
+        consumerStats_.on_pop(1);
+    }
+
+    /**
+     * @brief Output iterator that appends to the queue with batched publication.
+     *
+     * Writes through the iterator construct elements directly in the ring but only
+     * publish the producer's write index once every `batch` elements, when the queue
+     * fills up, or when the iterator is destroyed. Standard algorithms such as
+     * std::copy therefore pay one release store per block instead of one per element.
+     *
+     * Copies of the iterator share the producer's pending state in the queue, so the
+     * copies made by algorithms taking iterators by value stay consistent.
+     *
+     * @note Assignment blocks (spins) while the queue is full
+     * @note Must only be used from the producer thread
+     */
+    class back_insert_iterator
+    {
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        back_insert_iterator(const back_insert_iterator &) = default;
+        back_insert_iterator &operator=(const back_insert_iterator &) = default;
+
+        ~back_insert_iterator()
+        {
+            queue_->publish_pending();
+        }
+
+        back_insert_iterator &operator=(const T &value)
+        {
+            queue_->emplace_pending(batch_, value);
+            return *this;
+        }
+
+        back_insert_iterator &operator=(T &&value)
+        {
+            queue_->emplace_pending(batch_, std::move(value));
+            return *this;
+        }
+
+        back_insert_iterator &operator*() noexcept { return *this; }
+        back_insert_iterator &operator++() noexcept { return *this; }
+        back_insert_iterator &operator++(int) noexcept { return *this; }
+
+    private:
+        friend class spscq;
+
+        back_insert_iterator(spscq &queue, size_t batch) noexcept : queue_(&queue), batch_(batch) {}
+
+        spscq *queue_;
+        size_t batch_;
+    };
+
+    /**
+     * @brief Single-pass range over the elements currently available to the consumer.
+     *
+     * The range snapshots the producer's write index once on creation and iterates the
+     * elements in place. Each element is destroyed when the iterator advances past it,
+     * and the consumer's read index is published once when the range is destroyed.
+     * Elements that were not advanced past (for example after a `break`) stay in the queue.
+     *
+     * @note Must only be used from the consumer thread
+     */
+    class drain_range
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T *;
+            using reference = T &;
+
+            T &operator*() const noexcept { return range_->queue_->data_[range_->readIdx_]; }
+            T *operator->() const noexcept { return &**this; }
+
+            iterator &operator++() noexcept
+            {
+                range_->advance();
+                return *this;
+            }
+
+            bool operator==(const iterator &other) const noexcept { return at_end() == other.at_end(); }
+            bool operator!=(const iterator &other) const noexcept { return !(*this == other); }
+
+        private:
+            friend class drain_range;
+
+            explicit iterator(drain_range *range) noexcept : range_(range) {}
+
+            bool at_end() const noexcept { return range_ == nullptr || range_->readIdx_ == range_->endIdx_; }
+
+            drain_range *range_;
+        };
+
+        iterator begin() noexcept { return iterator(this); }
+        iterator end() noexcept { return iterator(nullptr); }
+
+        /** Number of elements remaining in the range. */
+        size_t size() const noexcept
+        {
+            return endIdx_ - readIdx_ + (endIdx_ < readIdx_ ? queue_->size_ : 0);
+        }
+
+        bool empty() const noexcept { return readIdx_ == endIdx_; }
+
+        ~drain_range()
+        {
+            if (readIdx_ != startIdx_)
+            {
+                queue_->readIdx_.store(readIdx_, std::memory_order_release);
+                queue_->consumerStats_.on_pop(queue_->used(readIdx_, startIdx_));
+            }
+        }
+
+        drain_range(const drain_range &) = delete;
+        drain_range &operator=(const drain_range &) = delete;
+
+    private:
+        friend class spscq;
+
+        drain_range(spscq &queue, size_t maxItems) noexcept : queue_(&queue)
+        {
+            assert(queue.pendingDestroy_ == 0 && "call reclaim() after try_pop_deferred");
+
+            startIdx_ = readIdx_ = queue.readIdx_.load(std::memory_order_relaxed);
+
+            const size_t writeIdx = queue.writeIdx_.load(std::memory_order_acquire);
+            queue.writeIdxCached_.store(writeIdx, std::memory_order_relaxed);
+
+            const size_t available = writeIdx - readIdx_ + (writeIdx < readIdx_ ? queue.size_ : 0);
+            endIdx_ = queue.advance(readIdx_, available < maxItems ? available : maxItems);
+        }
+
+        void advance() noexcept
+        {
+            queue_->data_[readIdx_].~T();
+            readIdx_ = queue_->increment(readIdx_);
+        }
+
+        spscq *queue_;
+        size_t startIdx_;
+        size_t readIdx_;
+        size_t endIdx_;
+    };
+
+    /**
+     * @brief Returns an output iterator appending to the queue with batched publication.
+     *
+     * @param batch Number of elements written between two publications of the write index
+     * @return back_insert_iterator Iterator usable with standard algorithms such as std::copy
+     *
+     * @note Must only be called from the producer thread, and only one such iterator
+     *       (with its copies) may be in use at a time
+     */
+    back_insert_iterator back_inserter(size_t batch = 64) noexcept
+    {
+        flush();
+        writeIdxPending_ = writeIdx_.load(std::memory_order_relaxed);
+        pendingCount_ = 0;
+        return back_insert_iterator(*this, batch == 0 ? 1 : batch);
+    }
+
+    /**
+     * @brief Returns a range over the elements currently available to the consumer.
+     *
+     * @param maxItems Upper bound on the number of elements in the range
+     * @return drain_range Range iterating the elements in place, publishing on destruction
+     *
+     * @note Must only be called from the consumer thread
+     */
+    drain_range drain(size_t maxItems = static_cast<size_t>(-1)) noexcept
+    {
+        return drain_range(*this, maxItems);
+    }
+
+    /**
+     * @brief Waits until maxItems elements are available or the deadline passes, then
+     *        returns a range over them.
+     *
+     * Only the producer's write index is polled while waiting, through the consumer's
+     * wait policy, so a batch costs one wakeup however many elements it holds. With
+     * sleep_wait the consumer spins, then yields, then sleeps, overshooting the deadline
+     * by at most one sleep.
+     *
+     * @param maxItems Number of elements that ends the wait, and upper bound on the range;
+     *        a full queue also ends the wait when maxItems exceeds capacity()
+     * @param deadline Time point after which the elements available so far are returned
+     * @return drain_range Range iterating up to maxItems elements in place, possibly empty
+     *
+     * @note Must only be called from the consumer thread
+     */
+    template <typename Clock, typename Duration>
+    drain_range gather(size_t maxItems, const std::chrono::time_point<Clock, Duration> &deadline)
+    {
+        wait_available(maxItems, deadline);
+        return drain_range(*this, maxItems);
+    }
+
+    /**
+     * @brief Waits like gather(maxItems, deadline) and moves the batch into a buffer.
+     *
+     * The buffer is cleared first and keeps its capacity, so reusing it across calls
+     * does not allocate in steady state.
+     *
+     * @param batch Buffer receiving the elements, replaced by the gathered batch
+     * @param maxItems Number of elements that ends the wait, and upper bound on the batch
+     * @param deadline Time point after which the elements available so far are returned
+     * @return size_t Number of elements gathered, from 0 to maxItems
+     *
+     * @note Must only be called from the consumer thread
+     */
+    template <typename Alloc, typename Clock, typename Duration>
+    size_t gather(std::vector<T, Alloc> &batch, size_t maxItems, const std::chrono::time_point<Clock, Duration> &deadline)
+    {
+        batch.clear();
+        for (T &value : gather(maxItems, deadline))
+        {
+            batch.push_back(std::move(value));
+        }
+        return batch.size();
+    }
+
+    /**
+     * @brief Returns the statistics recorded by the producer side.
+     *
+     * @note The returned object is written by the producer thread; reading it from another
+     *       thread is only safe if the Stats policy allows it, as counting_stats does
+     */
+    const Stats &producer_stats() const noexcept { return producerStats_; }
+
+    /**
+     * @brief Returns the statistics recorded by the consumer side.
+     *
+     * @note The returned object is written by the consumer thread; reading it from another
+     *       thread is only safe if the Stats policy allows it, as counting_stats does
+     */
+    const Stats &consumer_stats() const noexcept { return consumerStats_; }
+
+    /**
+     * @brief Returns the wait policy of the producer side, for policies that expose
+     *        what they learned, such as adaptive_wait.
+     */
+    const Wait &producer_wait() const noexcept { return producerWait_; }
+
+    /**
+     * @brief Returns the wait policy of the consumer side.
+     */
+    const Wait &consumer_wait() const noexcept { return consumerWait_; }
+
+    /**
+     * @brief Returns the maximum number of elements the queue can hold.
+     *
+     * @return size_t The capacity, one less than the size given at construction
+     */
+    size_t capacity() const noexcept { return size_ - 1; }
+
     /**
      * @brief Returns the current number of elements in the queue.
      *
@@ -165,27 +774,24 @@ public:
      * kept empty to distinguish between full and empty states).
      *
      * @param size The maximum capacity of the queue (actual capacity will be size-1)
-     * @param alloc The allocator instance to use for memory allocation
-     * @throws std::invalid_argument if size is 0
+     * @param storageArgs Arguments forwarded to the storage policy after the size, such
+     *        as the allocator instance for heap_storage or the buffer for external_storage
+     * @throws std::invalid_argument if size is 0 or rejected by the indexing policy
      * @throws std::bad_alloc if memory allocation fails
      *
      * @note The actual capacity of the queue will be size-1 elements
      */
-    explicit spscq(size_t size, const Allocator& alloc = Allocator()): allocator_(alloc), size_(size)
+    template <typename... StorageArgs>
+    explicit spscq(size_t size, StorageArgs &&...storageArgs)
+        : storage_(validate(size), std::forward<StorageArgs>(storageArgs)...), data_(storage_.data()), size_(size)
     {
-        if (size == 0) 
-        {
-            throw std::invalid_argument("Queue size must be greater than 0");
-        }
-
-        data_ = allocator_.allocate(size);
     }
 
     /**
      * @brief Destroys the queue and all contained elements.
      *
-     * Calls the destructor of all remaining elements in the queue and
-     * deallocates the memory using the allocator.
+     * Calls the destructor of all remaining elements in the queue, including
+     * elements pushed but not yet published, and releases the storage.
      *
      * @note This operation is not thread-safe and should only be called
      *       when no other threads are accessing the queue
@@ -193,15 +799,13 @@ public:
     ~spscq() noexcept
     {
         size_t r = readIdx_.load(std::memory_order_relaxed);
-        size_t w = writeIdx_.load(std::memory_order_relaxed);
+        size_t w = batched ? writeIdxPending_ : writeIdx_.load(std::memory_order_relaxed);
 
         while (r != w)
         {
             data_[r].~T();
             r = increment(r);
         }
-
-        allocator_.deallocate(data_, size_);
     }
 
     // Prevent accidental sharing between threads by making the queue non-copyable and non-movable.
@@ -210,37 +814,195 @@ public:
     spscq &operator=(const spscq &) = delete;
 
 private:
+    /** Whether pushes publish the write index in batches rather than one by one. */
+    static constexpr bool batched = Publication::batch > 1;
+
+    /** Most slots a single try_pop_deferred destroys while the queue is nearly full. */
+    static constexpr size_t reclaimChunk = 16;
+
+    /**
+     * @brief Destroys the oldest pending slots of try_pop_deferred and releases them.
+     *
+     * @param count Maximum number of slots to release
+     */
+    void release_pending(size_t count) noexcept
+    {
+        if (count > pendingDestroy_)
+        {
+            count = pendingDestroy_;
+        }
+        if (count == 0)
+        {
+            return;
+        }
+
+        size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i)
+        {
+            data_[readIdx].~T();
+            readIdx = increment(readIdx);
+        }
+        pendingDestroy_ -= count;
+
+        readIdx_.store(readIdx, std::memory_order_release);
+    }
+
+    /**
+     * @brief Checks a queue size before the storage is created.
+     *
+     * @throws std::invalid_argument if size is 0 or rejected by the indexing policy
+     */
+    static size_t validate(size_t size)
+    {
+        if (size == 0)
+        {
+            throw std::invalid_argument("Queue size must be greater than 0");
+        }
+
+        Indexing::validate(size);
+        return size;
+    }
+
     /**
      * @brief Increments an index with wrap-around at size_.
      *
      * Handles the circular nature of the queue by wrapping indices back to 0
-     * when they reach size_.
+     * when they reach size_, as defined by the indexing policy.
      *
      * @param index The current index
      * @return size_t The next index (wrapped around if necessary)
      */
     size_t increment(size_t index) const noexcept
     {
-        size_t nextIdx = index + 1;
-        return (nextIdx == size_) ? 0 : nextIdx;
+        return Indexing::next(index, size_);
     }
 
     /**
-     * @brief Size of a cache line in bytes.
+     * @brief Returns the number of elements between a read and a write index.
+     */
+    size_t used(size_t writeIdx, size_t readIdx) const noexcept
+    {
+        return writeIdx - readIdx + (writeIdx < readIdx ? size_ : 0);
+    }
+
+    /**
+     * @brief Returns the number of free slots between a write and a read index.
+     */
+    size_t space(size_t writeIdx, size_t readIdx) const noexcept
+    {
+        return size_ - 1 - used(writeIdx, readIdx);
+    }
+
+    /**
+     * @brief Advances an index by count positions with wrap-around at size_.
      *
-     * Used for aligning atomic variables to prevent false sharing between cores.
-     * Uses std::hardware_destructive_interference_size if available, otherwise
-     * falls back to a common cache line size of 64 bytes.
+     * @param index The current index
+     * @param count Number of positions to advance, at most size_
+     * @return size_t The advanced index
      */
-#ifdef __cpp_lib_hardware_interference_size
-    static constexpr size_t cacheLine_ = std::hardware_destructive_interference_size;
-#else
-    static constexpr size_t cacheLine_ = 64;
-#endif
+    size_t advance(size_t index, size_t count) const noexcept
+    {
+        return Indexing::advance(index, count, size_);
+    }
+
+    /**
+     * @brief Waits until minItems elements are readable, or the queue is full, or the
+     *        deadline passes.
+     *
+     * @return size_t Number of elements readable when the wait ended
+     */
+    template <typename Clock, typename Duration>
+    size_t wait_available(size_t minItems, const std::chrono::time_point<Clock, Duration> &deadline)
+    {
+        assert(pendingDestroy_ == 0 && "call reclaim() after try_pop_deferred");
+
+        // A full queue cannot hold more, and its producer waits for this consumer
+        if (minItems > capacity())
+        {
+            minItems = capacity();
+        }
+
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+        size_t available = used(writeIdxCached_, readIdx);
+
+        while (available < minItems)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+            available = used(writeIdxCached_, readIdx);
+            if (available >= minItems || Clock::now() >= deadline)
+            {
+                break;
+            }
+            consumerStats_.on_wait();
+            consumerWait_.wait();
+        }
+        consumerWait_.reset();
+
+        return available;
+    }
+
+    /**
+     * @brief Constructs an element at the producer's pending write index without publishing it.
+     *
+     * Publishes the pending elements once `batch` of them have accumulated. When the
+     * queue is full, publishes first so the consumer can make progress, then waits
+     * until a slot is released.
+     */
+    template <typename... Args>
+    void emplace_pending(size_t batch, Args &&...args)
+    {
+        const size_t writeIdx = writeIdxPending_;
+        const size_t nextWriteIdx = increment(writeIdx);
+
+        if (nextWriteIdx == readIdxCached_.load(std::memory_order_relaxed))
+        {
+            publish_pending();
+
+            size_t readIdx;
+            while (nextWriteIdx == (readIdx = readIdx_.load(std::memory_order_acquire)))
+            {
+                producerStats_.on_wait();
+                producerWait_.wait();
+            }
+            producerWait_.reset();
+            readIdxCached_.store(readIdx, std::memory_order_relaxed);
+        }
+
+        new (&data_[writeIdx]) T(std::forward<Args>(args)...);
+        writeIdxPending_ = nextWriteIdx;
+        producerStats_.on_push(1);
+
+        if (++pendingCount_ >= batch)
+        {
+            publish_pending();
+        }
+    }
+
+    /**
+     * @brief Publishes the elements constructed through emplace_pending.
+     */
+    void publish_pending() noexcept
+    {
+        if (pendingCount_ != 0)
+        {
+            writeIdx_.store(writeIdxPending_, std::memory_order_release);
+            pendingCount_ = 0;
+        }
+    }
+
+    /**
+     * @brief Distance in bytes kept between producer-owned and consumer-owned state.
+     *
+     * Used for aligning atomic variables to prevent false sharing between cores. With
+     * padded_layout this is SPSCQ_INTERFERENCE_SIZE (default 128, see spscq_config.hpp)
+     * rather than std::hardware_destructive_interference_size, so the layout does not
+     * depend on compiler flags; dense_layout packs the indices together.
+     */
+    static constexpr size_t cacheLine_ = Layout::alignment;
+
+    /** The storage policy instance owning the element buffer */
+    storage_type storage_;
 
-    /** The allocator instance used for memory management */
-    Allocator allocator_;
-    
     /** Pointer to the allocated storage for queue elements */
     T* data_;
     
@@ -249,15 +1011,47 @@ private:
 
     /**
      * Atomic indices for queue operations.
-     * Each index is aligned to a cache line to prevent false sharing between threads.
+     * Each index is aligned to cacheLine_ to prevent false sharing between threads.
      * 
      * readIdx_: Index where the consumer reads from
      * readIdxCached_: Consumer's cache of the producer's write index
      * writeIdx_: Index where the producer writes to
      * writeIdxCached_: Producer's cache of the consumer's read index
      */
-    alignas(cacheLine_) std::atomic<size_t> readIdx_{0};
-    alignas(cacheLine_) std::atomic<size_t> readIdxCached_{0};
-    alignas(cacheLine_) std::atomic<size_t> writeIdx_{0};
-    alignas(cacheLine_) std::atomic<size_t> writeIdxCached_{0};
+    alignas(cacheLine_) spscq_detail::atomic<size_t> readIdx_{0};
+    alignas(cacheLine_) spscq_detail::atomic<size_t> readIdxCached_{0};
+    alignas(cacheLine_) spscq_detail::atomic<size_t> writeIdx_{0};
+    alignas(cacheLine_) spscq_detail::atomic<size_t> writeIdxCached_{0};
+
+    /**
+     * Consumer-private count of slots popped by try_pop_deferred and not yet destroyed,
+     * sharing the line of writeIdxCached_. The slots start at readIdx_, which is only
+     * advanced past them by reclaim().
+     */
+    size_t pendingDestroy_ = 0;
+
+    /** Consumer-side wait and stats policy instances, sharing the same line. */
+    Wait consumerWait_;
+    Stats consumerStats_;
+
+    /**
+     * Producer-private state of the batched back_insert_iterator and of batched_publication.
+     *
+     * writeIdxPending_: Index of the next slot to construct, ahead of writeIdx_ by pendingCount_
+     * pendingCount_: Number of constructed elements not yet published
+     */
+    alignas(cacheLine_) size_t writeIdxPending_ = 0;
+    size_t pendingCount_ = 0;
+
+    /** Producer-side wait and stats policy instances, sharing the same line. */
+    Wait producerWait_;
+    Stats producerStats_;
 };
+
+/**
+ * @brief Queue tuned for endpoints on SMT siblings: dense indices and long pause bursts.
+ *
+ * shares_core() in spscq_placement.hpp detects such pairs.
+ */
+template <typename T>
+using spscq_smt = spscq<T, std::allocator<T>, wrap_indexing, eager_publication, smt_wait<>, no_stats, dense_layout>;
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+
+/**
+ * @brief A huge-page-backed bump arena for co-allocating many queues.
+ *
+ * The arena reserves one contiguous mapping up front and hands out aligned chunks of
+ * it. It first tries explicit huge pages (MAP_HUGETLB) and falls back to a regular
+ * mapping advised for transparent huge pages, so a whole set of queues shares a
+ * handful of TLB entries instead of being scattered across the heap.
+ *
+ * Individual chunks are never freed; the whole mapping is released when the arena
+ * is destroyed.
+ *
+ * @note The arena is not thread-safe. Allocate everything before sharing the memory
+ *       between threads.
+ */
+class spscq_arena
+{
+public:
+    /** Size of the huge pages the mapping is rounded up to */
+    static constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+    /**
+     * @brief Maps an arena of at least the given size.
+     *
+     * @param bytes Minimum number of bytes the arena must provide
+     * @throws std::bad_alloc if the mapping fails
+     */
+    explicit spscq_arena(size_t bytes)
+    {
+        capacity_ = (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+        if (capacity_ == 0)
+        {
+            capacity_ = hugePageSize;
+        }
+
+        void *base = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        hugePages_ = base != MAP_FAILED;
+
+        if (!hugePages_)
+        {
+            base = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+#ifdef MADV_HUGEPAGE
+            madvise(base, capacity_, MADV_HUGEPAGE);
+#endif
+        }
+
+        base_ = static_cast<std::byte *>(base);
+    }
+
+    ~spscq_arena() noexcept
+    {
+        munmap(base_, capacity_);
+    }
+
+    spscq_arena(const spscq_arena &) = delete;
+    spscq_arena &operator=(const spscq_arena &) = delete;
+
+    /**
+     * @brief Carves an aligned chunk out of the arena.
+     *
+     * @param bytes Size of the chunk
+     * @param alignment Alignment of the chunk, must be a power of two
+     * @return void* Pointer to the chunk
+     * @throws std::bad_alloc if the arena is exhausted
+     */
+    void *allocate(size_t bytes, size_t alignment)
+    {
+        const size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+        if (offset > capacity_ || bytes > capacity_ - offset)
+        {
+            throw std::bad_alloc();
+        }
+
+        used_ = offset + bytes;
+        return base_ + offset;
+    }
+
+    /** Returns true if the arena is backed by explicit huge pages */
+    bool huge_pages() const noexcept { return hugePages_; }
+
+    /** Returns the size of the mapping in bytes */
+    size_t capacity() const noexcept { return capacity_; }
+
+    /** Returns the number of bytes handed out so far, including alignment padding */
+    size_t used() const noexcept { return used_; }
+
+private:
+    std::byte *base_;
+    size_t capacity_;
+    size_t used_ = 0;
+    bool hugePages_;
+};
+
+/**
+ * @brief Standard allocator adapter drawing memory from an spscq_arena.
+ *
+ * deallocate() is a no-op: the memory is returned when the arena is destroyed.
+ *
+ * @tparam T The type of elements to allocate
+ */
+template <typename T>
+class arena_allocator
+{
+public:
+    using value_type = T;
+
+    /**
+     * @param arena Arena to draw from
+     * @param alignment Alignment of every allocation, a power of two; raising it to the
+     *        interference size keeps consecutive allocations off each other's lines
+     */
+    explicit arena_allocator(spscq_arena &arena, size_t alignment = alignof(T)) noexcept
+        : arena_(&arena), alignment_(alignment < alignof(T) ? alignof(T) : alignment)
+    {
+    }
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U> &other) noexcept
+        : arena_(other.arena_), alignment_(other.alignment_ < alignof(T) ? alignof(T) : other.alignment_)
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignment_));
+    }
+
+    /** Returns the alignment of the allocations */
+    size_t alignment() const noexcept { return alignment_; }
+
+    void deallocate(T *, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const arena_allocator<U> &other) const noexcept { return arena_ == other.arena_; }
+
+    template <typename U>
+    bool operator!=(const arena_allocator<U> &other) const noexcept { return arena_ != other.arena_; }
+
+private:
+    template <typename U>
+    friend class arena_allocator;
+
+    spscq_arena *arena_;
+    size_t alignment_;
+};
@@ -0,0 +1,375 @@
+#pragma once
+
+#include "spscq.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/**
+ * Wire format shared by spscq_bridge_sender and spscq_bridge_receiver.
+ *
+ * A stream is a sequence of frames, each an 8-byte element count in host byte order
+ * followed by that many elements as raw bytes. Both ends must therefore run on the
+ * same architecture and agree on T. Because frames are multiples of alignof(T) bytes,
+ * elements stay aligned in the receiver's buffer.
+ */
+namespace spscq_bridge_detail
+{
+    using frame_header = uint64_t;
+
+    /** Time a bridge thread sleeps in poll() before re-checking for shutdown */
+    inline constexpr int pollTimeoutMs = 10;
+
+    template <typename T>
+    constexpr void check_element()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "The type T must be trivially copyable to cross a socket.");
+        static_assert(alignof(T) <= alignof(frame_header), "The type T must not be aligned beyond the frame header.");
+    }
+}
+
+/**
+ * @brief Drains a local spscq and streams its elements over a connected socket.
+ *
+ * A background thread pops elements in batches with try_pop_n() and writes each batch
+ * as one frame with a single gather write (header and payload in one sendmsg call).
+ * Batching adapts to occupancy: the thread takes whatever is queued, up to maxBatch,
+ * so a lightly loaded queue is forwarded element by element with minimal latency and
+ * a backed-up queue is forwarded in large frames with few system calls.
+ *
+ * Back-pressure is inherited from the socket: when the peer stops reading, writes stop
+ * making progress, the sender stops draining and the local queue fills up.
+ *
+ * @tparam T The type of elements, trivially copyable
+ * @tparam Allocator The allocator type of the source queue
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class spscq_bridge_sender
+{
+public:
+    /**
+     * @brief Starts forwarding the source queue to the socket.
+     *
+     * @param source Queue to drain; the sender's thread becomes its consumer
+     * @param fd Connected stream socket (TCP or Unix), owned by the caller
+     * @param maxBatch Maximum number of elements per frame
+     */
+    spscq_bridge_sender(spscq<T, Allocator> &source, int fd, size_t maxBatch = 1024)
+        : source_(source), fd_(fd), maxBatch_(maxBatch == 0 ? 1 : maxBatch), batch_(new T[maxBatch_])
+    {
+        spscq_bridge_detail::check_element<T>();
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    /**
+     * @brief Forwards whatever is left in the source queue, then stops the thread.
+     *
+     * @note Blocks until the remaining elements are written or the socket fails
+     */
+    ~spscq_bridge_sender() noexcept
+    {
+        stop_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+
+    spscq_bridge_sender(const spscq_bridge_sender &) = delete;
+    spscq_bridge_sender &operator=(const spscq_bridge_sender &) = delete;
+
+    /** Returns the number of elements written to the socket so far */
+    uint64_t messages() const noexcept { return messages_.load(std::memory_order_relaxed); }
+
+    /** Returns the number of frames written to the socket so far */
+    uint64_t frames() const noexcept { return frames_.load(std::memory_order_relaxed); }
+
+    /** Returns the errno of the write that failed, or 0 while the socket is healthy */
+    int error() const noexcept { return error_.load(std::memory_order_relaxed); }
+
+private:
+    void run()
+    {
+        for (;;)
+        {
+            const size_t n = source_.try_pop_n(batch_.get(), maxBatch_);
+
+            if (n == 0)
+            {
+                if (stop_.load(std::memory_order_acquire) && source_.empty())
+                {
+                    return;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (!send_frame(n))
+            {
+                return;
+            }
+
+            messages_.store(messages_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            frames_.store(frames_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Writes the first n batched elements as one frame, retrying partial writes.
+     *
+     * @return false if the socket failed
+     */
+    bool send_frame(size_t n)
+    {
+        spscq_bridge_detail::frame_header header = n;
+
+        iovec iov[2];
+        iov[0].iov_base = &header;
+        iov[0].iov_len = sizeof(header);
+        iov[1].iov_base = batch_.get();
+        iov[1].iov_len = n * sizeof(T);
+
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = 2;
+
+        while (msg.msg_iovlen != 0)
+        {
+            const ssize_t written = sendmsg(fd_, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+            if (written < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    pollfd pfd{fd_, POLLOUT, 0};
+                    poll(&pfd, 1, spscq_bridge_detail::pollTimeoutMs);
+                    continue;
+                }
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                error_.store(errno, std::memory_order_relaxed);
+                return false;
+            }
+
+            size_t remaining = static_cast<size_t>(written);
+            while (msg.msg_iovlen != 0 && remaining >= msg.msg_iov->iov_len)
+            {
+                remaining -= msg.msg_iov->iov_len;
+                ++msg.msg_iov;
+                --msg.msg_iovlen;
+            }
+            if (msg.msg_iovlen != 0)
+            {
+                msg.msg_iov->iov_base = static_cast<std::byte *>(msg.msg_iov->iov_base) + remaining;
+                msg.msg_iov->iov_len -= remaining;
+            }
+        }
+
+        return true;
+    }
+
+    spscq<T, Allocator> &source_;
+    int fd_;
+    size_t maxBatch_;
+    std::unique_ptr<T[]> batch_;
+
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<int> error_{0};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+/**
+ * @brief Reads frames from a connected socket and pushes their elements into a local spscq.
+ *
+ * A background thread reads from the socket in large chunks and pushes every complete
+ * element it holds with a single try_push_n() call. While the sink queue is full the
+ * thread stops reading, so the socket buffers fill and the sender is throttled in turn.
+ *
+ * @tparam T The type of elements, trivially copyable
+ * @tparam Allocator The allocator type of the sink queue
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class spscq_bridge_receiver
+{
+public:
+    /**
+     * @brief Starts forwarding the socket to the sink queue.
+     *
+     * @param sink Queue to fill; the receiver's thread becomes its producer
+     * @param fd Connected stream socket (TCP or Unix), owned by the caller
+     * @param bufferSize Size of the read buffer in bytes
+     */
+    spscq_bridge_receiver(spscq<T, Allocator> &sink, int fd, size_t bufferSize = 64 * 1024)
+        : sink_(sink), fd_(fd)
+    {
+        spscq_bridge_detail::check_element<T>();
+
+        const size_t minimum = sizeof(spscq_bridge_detail::frame_header) + sizeof(T);
+        capacity_ = (bufferSize < minimum ? minimum : bufferSize) / sizeof(spscq_bridge_detail::frame_header) + 1;
+        buffer_.reset(new spscq_bridge_detail::frame_header[capacity_]);
+        capacity_ *= sizeof(spscq_bridge_detail::frame_header);
+
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    /**
+     * @brief Stops the thread.
+     *
+     * Elements still buffered or in flight on the socket are discarded.
+     */
+    ~spscq_bridge_receiver() noexcept
+    {
+        stop_.store(true, std::memory_order_relaxed);
+        thread_.join();
+    }
+
+    spscq_bridge_receiver(const spscq_bridge_receiver &) = delete;
+    spscq_bridge_receiver &operator=(const spscq_bridge_receiver &) = delete;
+
+    /** Returns the number of elements pushed into the sink so far */
+    uint64_t messages() const noexcept { return messages_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns true once the connection ended and every element was pushed.
+     *
+     * The connection ends when the peer closes it or when a read fails; error() tells
+     * the two apart.
+     */
+    bool finished() const noexcept { return finished_.load(std::memory_order_acquire); }
+
+    /** Returns the errno of the read that failed, such as ECONNRESET, or 0 on a clean close */
+    int error() const noexcept { return error_.load(std::memory_order_relaxed); }
+
+private:
+    void run()
+    {
+        std::byte *buffer = reinterpret_cast<std::byte *>(buffer_.get());
+        size_t begin = 0;
+        size_t end = 0;
+        bool eof = false;
+
+        while (!stop_.load(std::memory_order_relaxed))
+        {
+            begin = parse(buffer, begin, end);
+            if (begin == end)
+            {
+                begin = end = 0;
+            }
+
+            if (pending_ != 0 && end - begin >= sizeof(T))
+            {
+                // The sink is full: stop reading so the socket pushes back on the sender
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (eof)
+            {
+                // Anything left is a truncated frame that can never complete
+                finished_.store(true, std::memory_order_release);
+                return;
+            }
+
+            if (end == capacity_)
+            {
+                // Keep the partial header or element, moving it by a multiple of alignof(T)
+                std::memmove(buffer, buffer + begin, end - begin);
+                end -= begin;
+                begin = 0;
+            }
+
+            const ssize_t received = recv(fd_, buffer + end, capacity_ - end, MSG_DONTWAIT);
+
+            if (received > 0)
+            {
+                end += static_cast<size_t>(received);
+            }
+            else if (received == 0)
+            {
+                eof = true;
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                pollfd pfd{fd_, POLLIN, 0};
+                poll(&pfd, 1, spscq_bridge_detail::pollTimeoutMs);
+            }
+            else
+            {
+                // Push what was received before the failure, then finish with the error
+                error_.store(errno, std::memory_order_relaxed);
+                eof = true;
+            }
+        }
+    }
+
+    /**
+     * @brief Consumes frame headers and pushes complete elements from buffer[begin, end).
+     *
+     * @return size_t Offset of the first byte not consumed
+     */
+    size_t parse(std::byte *buffer, size_t begin, size_t end)
+    {
+        for (;;)
+        {
+            if (pending_ == 0)
+            {
+                if (end - begin < sizeof(spscq_bridge_detail::frame_header))
+                {
+                    return begin;
+                }
+
+                std::memcpy(&pending_, buffer + begin, sizeof(spscq_bridge_detail::frame_header));
+                begin += sizeof(spscq_bridge_detail::frame_header);
+                continue;
+            }
+
+            size_t whole = (end - begin) / sizeof(T);
+            if (whole > pending_)
+            {
+                whole = static_cast<size_t>(pending_);
+            }
+            if (whole == 0)
+            {
+                return begin;
+            }
+
+            const size_t pushed = sink_.try_push_n(reinterpret_cast<const T *>(buffer + begin), whole);
+            begin += pushed * sizeof(T);
+            pending_ -= pushed;
+            messages_.store(messages_.load(std::memory_order_relaxed) + pushed, std::memory_order_relaxed);
+
+            if (pushed != whole)
+            {
+                return begin;
+            }
+        }
+    }
+
+    spscq<T, Allocator> &sink_;
+    int fd_;
+
+    /** Read buffer, allocated as frame headers so that elements in it are aligned */
+    std::unique_ptr<spscq_bridge_detail::frame_header[]> buffer_;
+    size_t capacity_;
+
+    /** Number of elements of the current frame not pushed yet */
+    spscq_bridge_detail::frame_header pending_ = 0;
+
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<int> error_{0};
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
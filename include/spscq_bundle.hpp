@@ -0,0 +1,288 @@
+#pragma once
+
+#include "spscq_config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Several typed SPSC channels between the same two threads, sharing their index lines.
+ *
+ * N separate spscq instances between one producer and one consumer bounce N producer
+ * index lines and N consumer index lines. spscq_bundle<Ts...> keeps one ring per
+ * channel but puts the published write indices of all channels on a single
+ * producer-owned line and the published read indices on a single consumer-owned line.
+ *
+ * Publication is explicit and covers every channel at once: try_push<I>() only stages
+ * the element, and publish() makes everything staged visible with one release fence
+ * and stores to the one line. Likewise try_pop<I>() only advances the consumer's
+ * private position and release() frees the slots of every channel. When a side finds
+ * a channel full (or empty) it refreshes its cached copies of all the peer's indices
+ * with one line transfer, and publishes its own progress so neither side can wait on
+ * the other's unpublished work.
+ *
+ * Indices are free-running and capacities are powers of two, so every slot is usable.
+ *
+ * @tparam Ts The element types of the channels, one ring each
+ *
+ * @note This bundle is designed for single-producer single-consumer scenarios only.
+ */
+template <typename... Ts>
+class spscq_bundle
+{
+public:
+    static constexpr size_t channels = sizeof...(Ts);
+
+    static_assert(channels > 0, "A bundle must have at least one channel.");
+    static_assert(channels * sizeof(size_t) <= spscq_config::interferenceSize,
+                  "The indices of all channels must fit in one interference block.");
+
+    template <size_t I>
+    using element_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    /**
+     * @brief Constructs a bundle with one ring per channel.
+     *
+     * @param capacity Minimum number of elements per channel, rounded up to a power of two
+     * @throws std::invalid_argument if capacity is 0
+     * @throws std::bad_alloc if memory allocation fails
+     */
+    explicit spscq_bundle(size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("Queue capacity must be greater than 0");
+        }
+
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size *= 2;
+        }
+        mask_ = size - 1;
+
+        allocate(std::index_sequence_for<Ts...>{});
+    }
+
+    /**
+     * @brief Destroys the elements staged or published and not yet popped, and
+     *        deallocates every ring.
+     *
+     * @note This operation is not thread-safe and should only be called
+     *       when no other threads are accessing the bundle
+     */
+    ~spscq_bundle() noexcept
+    {
+        destroy_all(std::index_sequence_for<Ts...>{});
+        deallocate(std::index_sequence_for<Ts...>{});
+    }
+
+    spscq_bundle(const spscq_bundle &) = delete;
+    spscq_bundle &operator=(const spscq_bundle &) = delete;
+
+    /**
+     * @brief Attempts to construct an element in-place at the back of channel I.
+     *
+     * The element is staged and becomes visible to the consumer on the next publish().
+     *
+     * @param args Arguments forwarded to the element's constructor
+     * @return true if the element was staged
+     * @return false if the channel was full, in which case all staged elements are published
+     *
+     * @note Must only be called from the producer thread
+     */
+    template <size_t I, typename... Args>
+    bool try_emplace(Args &&...args)
+    {
+        const size_t writeIdx = producer_.position[I];
+
+        if (writeIdx - producer_.peerCached[I] > mask_)
+        {
+            refresh(consumerIdx_, producer_.peerCached);
+            if (writeIdx - producer_.peerCached[I] > mask_)
+            {
+                publish();
+                return false;
+            }
+        }
+
+        new (&std::get<I>(rings_)[writeIdx & mask_]) element_type<I>(std::forward<Args>(args)...);
+        producer_.position[I] = writeIdx + 1;
+
+        return true;
+    }
+
+    /**
+     * @brief Attempts to stage an element at the back of channel I.
+     *
+     * @note Must only be called from the producer thread
+     */
+    template <size_t I, typename U>
+    bool try_push(U &&value)
+    {
+        return try_emplace<I>(std::forward<U>(value));
+    }
+
+    /**
+     * @brief Makes the elements staged on every channel visible to the consumer.
+     *
+     * @note Must only be called from the producer thread
+     */
+    void publish() noexcept { announce(producer_.position, producerIdx_); }
+
+    /**
+     * @brief Attempts to move the front element of channel I out.
+     *
+     * The slot is freed for the producer on the next release().
+     *
+     * @param value Reference where the removed element will be stored
+     * @return true if an element was removed
+     * @return false if the channel was empty, in which case all popped slots are released
+     *
+     * @note Must only be called from the consumer thread
+     */
+    template <size_t I>
+    bool try_pop(element_type<I> &value)
+    {
+        const size_t readIdx = consumer_.position[I];
+
+        if (readIdx == consumer_.peerCached[I])
+        {
+            refresh(producerIdx_, consumer_.peerCached);
+            if (readIdx == consumer_.peerCached[I])
+            {
+                release();
+                return false;
+            }
+        }
+
+        element_type<I> &slot = std::get<I>(rings_)[readIdx & mask_];
+        value = std::move(slot);
+        slot.~element_type<I>();
+        consumer_.position[I] = readIdx + 1;
+
+        return true;
+    }
+
+    /**
+     * @brief Frees the slots of the elements popped from every channel.
+     *
+     * @note Must only be called from the consumer thread
+     */
+    void release() noexcept { announce(consumer_.position, consumerIdx_); }
+
+    /** Returns the number of elements each channel can hold */
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    /**
+     * @brief Returns the number of published elements of channel I not yet released.
+     *
+     * @note The result is a snapshot and may be stale by the time the caller uses it
+     */
+    template <size_t I>
+    size_t size() const noexcept
+    {
+        const size_t readIdx = consumerIdx_.index[I].load(std::memory_order_acquire);
+        return producerIdx_.index[I].load(std::memory_order_relaxed) - readIdx;
+    }
+
+private:
+    /** Indices of every channel published by one side, alone on their line */
+    struct alignas(spscq_config::interferenceSize) shared_indices
+    {
+        std::atomic<size_t> index[channels] = {};
+    };
+
+    /** One side's private positions and its cache of the other side's shared indices */
+    struct alignas(spscq_config::interferenceSize) private_indices
+    {
+        size_t position[channels] = {};
+        size_t peerCached[channels] = {};
+    };
+
+    /**
+     * @brief Publishes every position that moved, with one release fence for all.
+     */
+    static void announce(const size_t (&position)[channels], shared_indices &shared) noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < channels; ++i)
+        {
+            if (shared.index[i].load(std::memory_order_relaxed) != position[i])
+            {
+                shared.index[i].store(position[i], std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Copies the peer's indices of every channel, with one acquire fence for all.
+     */
+    static void refresh(const shared_indices &shared, size_t (&cached)[channels]) noexcept
+    {
+        for (size_t i = 0; i < channels; ++i)
+        {
+            cached[i] = shared.index[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    template <size_t... Is>
+    void allocate(std::index_sequence<Is...>)
+    {
+        // Rings allocated before a failure are released by the catch below
+        try
+        {
+            ((std::get<Is>(rings_) = std::allocator<Ts>().allocate(capacity())), ...);
+        }
+        catch (...)
+        {
+            deallocate(std::index_sequence<Is...>{});
+            throw;
+        }
+    }
+
+    template <size_t... Is>
+    void deallocate(std::index_sequence<Is...>) noexcept
+    {
+        ((std::get<Is>(rings_) != nullptr ? std::allocator<Ts>().deallocate(std::get<Is>(rings_), capacity()) : void()), ...);
+    }
+
+    template <size_t... Is>
+    void destroy_all(std::index_sequence<Is...>) noexcept
+    {
+        (destroy<Is>(), ...);
+    }
+
+    template <size_t I>
+    void destroy() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<element_type<I>>)
+        {
+            for (size_t idx = consumer_.position[I]; idx != producer_.position[I]; ++idx)
+            {
+                std::get<I>(rings_)[idx & mask_].~element_type<I>();
+            }
+        }
+    }
+
+    /** One ring array per channel */
+    std::tuple<Ts *...> rings_{};
+    size_t mask_;
+
+    /**
+     * producerIdx_: Write indices of every channel, published by the producer
+     * producer_: Producer's write positions, staged ahead of producerIdx_, and cached read indices
+     * consumerIdx_: Read indices of every channel, published by the consumer
+     * consumer_: Consumer's read positions, ahead of consumerIdx_, and cached write indices
+     */
+    shared_indices producerIdx_;
+    private_indices producer_;
+    shared_indices consumerIdx_;
+    private_indices consumer_;
+};
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "spscq_config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+class spscq_producer;
+
+template <typename T>
+class spscq_consumer;
+
+namespace spscq_detail
+{
+    /**
+     * @brief Shared state of a channel: the ring buffer and the two published indices.
+     *
+     * Indices are free-running positions, masked into the power-of-two ring on access,
+     * so every slot of the ring is usable.
+     */
+    template <typename T, typename Allocator>
+    struct channel_state
+    {
+        channel_state(size_t size, const Allocator &alloc) : allocator(alloc), size(size)
+        {
+            data = allocator.allocate(size);
+        }
+
+        ~channel_state() noexcept
+        {
+            const size_t w = writeIdx.load(std::memory_order_relaxed);
+            for (size_t r = readIdx.load(std::memory_order_relaxed); r != w; ++r)
+            {
+                data[r & (size - 1)].~T();
+            }
+
+            allocator.deallocate(data, size);
+        }
+
+        Allocator allocator;
+        T *data;
+        size_t size;
+
+        alignas(spscq_config::interferenceSize) std::atomic<size_t> writeIdx{0};
+        alignas(spscq_config::interferenceSize) std::atomic<size_t> readIdx{0};
+    };
+}
+
+/**
+ * @brief Creates an SPSC channel and returns its producer and consumer endpoints.
+ *
+ * Unlike spscq, which keeps both sides' private state in one shared object, each
+ * endpoint carries its own position, cached peer index, ring pointer and mask, and
+ * only touches the shared state to publish its index or to refresh the peer's. An
+ * endpoint can therefore live on its owning thread's stack or in its hot struct.
+ *
+ * The endpoints are move-only and expose only their side's operations, so pushing
+ * through a consumer or popping through a producer does not compile.
+ *
+ * @tparam T The type of elements exchanged over the channel
+ * @tparam Allocator The allocator type used for the ring buffer
+ * @param capacity Minimum number of elements the channel can hold, rounded up to a power of two
+ * @param alloc The allocator instance to use for the ring buffer
+ * @throws std::invalid_argument if capacity is 0
+ * @throws std::bad_alloc if memory allocation fails
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+std::pair<spscq_producer<T>, spscq_consumer<T>> make_channel(size_t capacity, const Allocator &alloc = Allocator())
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("Channel capacity must be greater than 0");
+    }
+
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+
+    auto state = std::make_shared<spscq_detail::channel_state<T, Allocator>>(size, alloc);
+
+    return {spscq_producer<T>(state, state->data, size - 1, state->writeIdx, state->readIdx),
+            spscq_consumer<T>(state, state->data, size - 1, state->readIdx, state->writeIdx)};
+}
+
+/**
+ * @brief Producer endpoint of a channel created by make_channel().
+ *
+ * @note Must only be used from one thread at a time
+ */
+template <typename T>
+class spscq_producer
+{
+public:
+    /**
+     * @brief Attempts to construct an element in-place at the back of the channel.
+     *
+     * @param args Arguments forwarded to the element's constructor
+     * @return true if the element was successfully constructed and published
+     * @return false if the channel was full
+     */
+    template <typename... Args>
+    bool try_emplace(Args &&...args) noexcept(std::is_nothrow_constructible<T, Args &&...>::value)
+    {
+        static_assert(std::is_constructible_v<T, Args...>, "The type T must support construction with the provided arguments.");
+
+        if (writeIdx_ - readIdxCached_ > mask_)
+        {
+            readIdxCached_ = peerIdx_->load(std::memory_order_acquire);
+            if (writeIdx_ - readIdxCached_ > mask_)
+            {
+                return false;
+            }
+        }
+
+        new (&data_[writeIdx_ & mask_]) T(std::forward<Args>(args)...);
+        sharedIdx_->store(++writeIdx_, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Attempts to add an element to the back of the channel.
+     *
+     * @param value Value to push into the channel
+     * @return true if the element was successfully added
+     * @return false if the channel was full
+     */
+    template <typename P>
+    bool try_push(P &&value)
+    {
+        return try_emplace(std::forward<P>(value));
+    }
+
+    /** Returns the number of elements the channel can hold */
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    spscq_producer(spscq_producer &&) noexcept = default;
+    spscq_producer &operator=(spscq_producer &&) noexcept = default;
+    spscq_producer(const spscq_producer &) = delete;
+    spscq_producer &operator=(const spscq_producer &) = delete;
+
+private:
+    template <typename U, typename Allocator>
+    friend std::pair<spscq_producer<U>, spscq_consumer<U>> make_channel(size_t, const Allocator &);
+
+    spscq_producer(std::shared_ptr<void> state, T *data, size_t mask,
+                   std::atomic<size_t> &sharedIdx, const std::atomic<size_t> &peerIdx) noexcept
+        : data_(data), mask_(mask), sharedIdx_(&sharedIdx), peerIdx_(&peerIdx), state_(std::move(state))
+    {
+    }
+
+    /** Producer-local copies of the ring pointer and mask */
+    T *data_;
+    size_t mask_;
+
+    /** Producer-local position and cache of the consumer's published position */
+    size_t writeIdx_ = 0;
+    size_t readIdxCached_ = 0;
+
+    /** Shared indices: the one this endpoint publishes and the one it refreshes from */
+    std::atomic<size_t> *sharedIdx_;
+    const std::atomic<size_t> *peerIdx_;
+
+    /** Keeps the shared state alive while either endpoint exists */
+    std::shared_ptr<void> state_;
+};
+
+/**
+ * @brief Consumer endpoint of a channel created by make_channel().
+ *
+ * @note Must only be used from one thread at a time
+ */
+template <typename T>
+class spscq_consumer
+{
+public:
+    /**
+     * @brief Attempts to remove and return the front element of the channel.
+     *
+     * @param value Reference where the removed element will be stored
+     * @return true if an element was successfully removed
+     * @return false if the channel was empty
+     */
+    bool try_pop(T &value)
+    {
+        T *element = front();
+        if (element == nullptr)
+        {
+            return false;
+        }
+
+        value = std::move(*element);
+        pop();
+
+        return true;
+    }
+
+    /**
+     * @brief Returns a pointer to the front element without removing it.
+     *
+     * @return T* Pointer to the front element, or nullptr if the channel is empty
+     */
+    T *front() noexcept
+    {
+        if (readIdx_ == writeIdxCached_)
+        {
+            writeIdxCached_ = peerIdx_->load(std::memory_order_acquire);
+            if (readIdx_ == writeIdxCached_)
+            {
+                return nullptr;
+            }
+        }
+
+        return &data_[readIdx_ & mask_];
+    }
+
+    /**
+     * @brief Removes the front element of the channel.
+     *
+     * @note Must only be called after front() returned a non-null pointer
+     */
+    void pop() noexcept
+    {
+        data_[readIdx_ & mask_].~T();
+        sharedIdx_->store(++readIdx_, std::memory_order_release);
+    }
+
+    /** Returns the number of elements the channel can hold */
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    spscq_consumer(spscq_consumer &&) noexcept = default;
+    spscq_consumer &operator=(spscq_consumer &&) noexcept = default;
+    spscq_consumer(const spscq_consumer &) = delete;
+    spscq_consumer &operator=(const spscq_consumer &) = delete;
+
+private:
+    template <typename U, typename Allocator>
+    friend std::pair<spscq_producer<U>, spscq_consumer<U>> make_channel(size_t, const Allocator &);
+
+    spscq_consumer(std::shared_ptr<void> state, T *data, size_t mask,
+                   std::atomic<size_t> &sharedIdx, const std::atomic<size_t> &peerIdx) noexcept
+        : data_(data), mask_(mask), sharedIdx_(&sharedIdx), peerIdx_(&peerIdx), state_(std::move(state))
+    {
+    }
+
+    /** Consumer-local copies of the ring pointer and mask */
+    T *data_;
+    size_t mask_;
+
+    /** Consumer-local position and cache of the producer's published position */
+    size_t readIdx_ = 0;
+    size_t writeIdxCached_ = 0;
+
+    /** Shared indices: the one this endpoint publishes and the one it refreshes from */
+    std::atomic<size_t> *sharedIdx_;
+    const std::atomic<size_t> *peerIdx_;
+
+    /** Keeps the shared state alive while either endpoint exists */
+    std::shared_ptr<void> state_;
+};
@@ -0,0 +1,366 @@
+#pragma once
+
+#include "spscq.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Block format shared by spscq_delta_writer and spscq_delta_reader.
+ *
+ * Values travel through an spscq<uint64_t> in blocks of up to blockValues values. A block
+ * is a header word (value count in the low 32 bits, bit width in the high 32 bits), the
+ * first value as is, then the zigzag-encoded differences between consecutive values,
+ * each packed on `width` bits. Differences are split over `lanes` interleaved bit
+ * streams (value i goes to stream i % lanes and stream words alternate), so packing and
+ * unpacking apply the same shifts to `lanes` values at once and compile to vector code.
+ */
+namespace spscq_codec_detail
+{
+    inline constexpr size_t lanes = 4;
+    inline constexpr size_t blockValues = 128;
+
+    /** Largest block: header, first value and 64-bit differences */
+    inline constexpr size_t maxBlockWords = 2 + blockValues;
+
+    inline uint64_t zigzag(uint64_t delta) noexcept
+    {
+        return (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+    }
+
+    inline uint64_t unzigzag(uint64_t value) noexcept
+    {
+        return (value >> 1) ^ (0 - (value & 1));
+    }
+
+    /** Number of packed words holding `rows` rows of `lanes` differences of `width` bits. */
+    inline size_t packed_words(size_t rows, unsigned width) noexcept
+    {
+        return lanes * ((rows * width + 63) / 64);
+    }
+
+    inline void pack(const uint64_t *deltas, size_t rows, unsigned width, uint64_t *out) noexcept
+    {
+        if (width == 0)
+        {
+            return;
+        }
+
+        uint64_t acc[lanes] = {};
+        unsigned fill = 0;
+
+        for (size_t row = 0; row < rows; ++row)
+        {
+            const uint64_t *v = deltas + row * lanes;
+            for (size_t j = 0; j < lanes; ++j)
+            {
+                acc[j] |= v[j] << fill;
+            }
+
+            fill += width;
+            if (fill >= 64)
+            {
+                fill -= 64;
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    out[j] = acc[j];
+                    // Bits of v[j] that did not fit in the word just written
+                    acc[j] = fill == 0 ? 0 : v[j] >> (width - fill);
+                }
+                out += lanes;
+            }
+        }
+
+        if (fill != 0)
+        {
+            std::copy(acc, acc + lanes, out);
+        }
+    }
+
+    inline void unpack(const uint64_t *in, size_t rows, unsigned width, uint64_t *deltas) noexcept
+    {
+        if (width == 0)
+        {
+            std::fill(deltas, deltas + rows * lanes, 0);
+            return;
+        }
+
+        const uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        unsigned fill = 0;
+
+        for (size_t row = 0; row < rows; ++row)
+        {
+            uint64_t *v = deltas + row * lanes;
+            if (fill + width > 64)
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    v[j] = ((in[j] >> fill) | (in[lanes + j] << (64 - fill))) & mask;
+                }
+            }
+            else
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    v[j] = (in[j] >> fill) & mask;
+                }
+            }
+
+            fill += width;
+            if (fill >= 64)
+            {
+                fill -= 64;
+                in += lanes;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Delta-encodes and bit-packs integer values into an spscq<uint64_t>.
+ *
+ * Values are buffered into blocks and each full block is encoded and pushed with bulk
+ * pushes, so slowly changing streams such as timestamps, sequence numbers or prices in
+ * ticks cross the ring in a fraction of their raw size. This pays off when moving bytes
+ * costs more than the CPU time of encoding, typically when the queue's two ends are on
+ * different sockets.
+ *
+ * A block becomes visible to the reader only when it is full or flush() is called.
+ *
+ * @tparam T Integral type of the values, at most 64 bits
+ * @tparam Queue Queue of uint64_t words with try_push_n, such as spscq<uint64_t>
+ *
+ * @note Must only be used from the queue's producer thread
+ */
+template <typename T, typename Queue = spscq<uint64_t>>
+class spscq_delta_writer
+{
+public:
+    static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t), "The type T must be an integer of at most 64 bits.");
+
+    explicit spscq_delta_writer(Queue &queue) noexcept : queue_(queue) {}
+
+    /** Pushes the values of the incomplete block. */
+    ~spscq_delta_writer() { flush(); }
+
+    spscq_delta_writer(const spscq_delta_writer &) = delete;
+    spscq_delta_writer &operator=(const spscq_delta_writer &) = delete;
+
+    /**
+     * @brief Appends a value, encoding and pushing the block when it is full.
+     *
+     * @note Waits for space in the queue when a full block does not fit
+     */
+    void push(T value)
+    {
+        values_[count_++] = static_cast<uint64_t>(value);
+        if (count_ == spscq_codec_detail::blockValues)
+        {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Appends a block of values.
+     */
+    void push_n(const T *values, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            push(values[i]);
+        }
+    }
+
+    /**
+     * @brief Encodes and pushes the values of the incomplete block, if any.
+     *
+     * @note Waits for space in the queue until the whole block is pushed
+     */
+    void flush()
+    {
+        if (count_ == 0)
+        {
+            return;
+        }
+
+        using namespace spscq_codec_detail;
+
+        const size_t rows = (count_ + lanes - 1) / lanes;
+
+        uint64_t deltas[blockValues];
+        uint64_t bits = 0;
+        uint64_t previous = values_[0];
+        for (size_t i = 0; i < count_; ++i)
+        {
+            deltas[i] = zigzag(values_[i] - previous);
+            previous = values_[i];
+            bits |= deltas[i];
+        }
+        std::fill(deltas + count_, deltas + rows * lanes, 0);
+
+        const unsigned width = bits == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(bits));
+
+        uint64_t words[maxBlockWords];
+        words[0] = count_ | (static_cast<uint64_t>(width) << 32);
+        words[1] = values_[0];
+        pack(deltas, rows, width, words + 2);
+
+        const size_t total = 2 + packed_words(rows, width);
+        for (size_t pushed = 0; pushed < total;)
+        {
+            const size_t n = queue_.try_push_n(words + pushed, total - pushed);
+            if (n == 0)
+            {
+                spscq_detail::cpu_relax();
+            }
+            pushed += n;
+        }
+
+        valueCount_ += count_;
+        wordCount_ += total;
+        count_ = 0;
+    }
+
+    /** Number of values pushed to the queue so far */
+    uint64_t values() const noexcept { return valueCount_; }
+
+    /** Number of bytes pushed to the queue so far, headers included */
+    uint64_t bytes() const noexcept { return wordCount_ * sizeof(uint64_t); }
+
+private:
+    Queue &queue_;
+    size_t count_ = 0;
+    uint64_t valueCount_ = 0;
+    uint64_t wordCount_ = 0;
+    uint64_t values_[spscq_codec_detail::blockValues];
+};
+
+/**
+ * @brief Decoded block returned by spscq_delta_reader::try_read().
+ *
+ * Points into the reader and stays valid until its next call.
+ */
+template <typename T>
+struct spscq_delta_block
+{
+    const T *data;
+    size_t size;
+
+    const T *begin() const noexcept { return data; }
+    const T *end() const noexcept { return data + size; }
+    bool empty() const noexcept { return size == 0; }
+};
+
+/**
+ * @brief Decodes the blocks written by spscq_delta_writer.
+ *
+ * Words are popped in bulk as they arrive; a block that is only partly published is
+ * kept until the rest arrives, so the reader never waits inside a call.
+ *
+ * @tparam T Integral type of the values, the same as the writer's
+ * @tparam Queue Queue of uint64_t words with try_pop_n, such as spscq<uint64_t>
+ *
+ * @note Must only be used from the queue's consumer thread
+ */
+template <typename T, typename Queue = spscq<uint64_t>>
+class spscq_delta_reader
+{
+public:
+    static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t), "The type T must be an integer of at most 64 bits.");
+
+    explicit spscq_delta_reader(Queue &queue) noexcept : queue_(queue) {}
+
+    spscq_delta_reader(const spscq_delta_reader &) = delete;
+    spscq_delta_reader &operator=(const spscq_delta_reader &) = delete;
+
+    /**
+     * @brief Decodes the next block if it has fully arrived.
+     *
+     * @return spscq_delta_block<T> The decoded values, empty if no complete block is available
+     *
+     * @note Values of the block returned by the previous call that were not taken
+     *       with try_pop_n() are skipped
+     */
+    spscq_delta_block<T> try_read()
+    {
+        using namespace spscq_codec_detail;
+
+        decodedSize_ = decodedPos_ = 0;
+
+        if (needed_ == 0)
+        {
+            // Header and first value, which may arrive separately
+            received_ += queue_.try_pop_n(words_ + received_, 2 - received_);
+            if (received_ < 2)
+            {
+                return {decoded_, 0};
+            }
+            const size_t count = static_cast<uint32_t>(words_[0]);
+            const unsigned width = static_cast<unsigned>(words_[0] >> 32);
+            needed_ = 2 + packed_words((count + lanes - 1) / lanes, width);
+        }
+
+        received_ += queue_.try_pop_n(words_ + received_, needed_ - received_);
+        if (received_ < needed_)
+        {
+            return {decoded_, 0};
+        }
+
+        decode();
+        received_ = needed_ = 0;
+        return {decoded_, decodedSize_};
+    }
+
+    /**
+     * @brief Moves up to maxCount decoded values into values.
+     *
+     * @return size_t Number of values copied, 0 if no complete block is available
+     */
+    size_t try_pop_n(T *values, size_t maxCount)
+    {
+        if (decodedPos_ == decodedSize_ && try_read().empty())
+        {
+            return 0;
+        }
+
+        const size_t n = std::min(maxCount, decodedSize_ - decodedPos_);
+        std::copy(decoded_ + decodedPos_, decoded_ + decodedPos_ + n, values);
+        decodedPos_ += n;
+        return n;
+    }
+
+private:
+    void decode() noexcept
+    {
+        using namespace spscq_codec_detail;
+
+        const size_t count = static_cast<uint32_t>(words_[0]);
+        const unsigned width = static_cast<unsigned>(words_[0] >> 32);
+        const size_t rows = (count + lanes - 1) / lanes;
+
+        uint64_t deltas[blockValues];
+        unpack(words_ + 2, rows, width, deltas);
+
+        uint64_t value = words_[1];
+        for (size_t i = 0; i < count; ++i)
+        {
+            value += unzigzag(deltas[i]);
+            decoded_[i] = static_cast<T>(value);
+        }
+
+        decodedSize_ = count;
+    }
+
+    Queue &queue_;
+
+    /** Words of the block being received */
+    uint64_t words_[spscq_codec_detail::maxBlockWords];
+    size_t received_ = 0;
+    size_t needed_ = 0;
+
+    T decoded_[spscq_codec_detail::blockValues];
+    size_t decodedSize_ = 0;
+    size_t decodedPos_ = 0;
+};
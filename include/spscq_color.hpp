@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+/**
+ * @brief Cache-set coloring for many co-resident queues.
+ *
+ * Power-of-two ring buffers and queue objects that all start at page-aligned addresses
+ * map their hot lines (slot 0, the index block) to the same L1/L2 cache sets, so a few
+ * dozen queues evict each other even though the cache has room for all of them.
+ * Coloring shifts each allocation by a per-instance multiple of the cache line size,
+ * spreading the hot lines of different queues over different sets.
+ *
+ * colored_allocator staggers a queue's ring buffer and make_colored() staggers the
+ * queue object itself, which holds its index block.
+ */
+namespace cache_color
+{
+    /** Granularity of the color offsets */
+    inline constexpr size_t lineSize = 64;
+
+    /** Alignment of the base of colored allocations */
+    inline constexpr size_t pageSize = 4096;
+
+    /** Default number of colors: one per line of a page, which covers the L1 sets */
+    inline constexpr size_t defaultColors = pageSize / lineSize;
+
+    /**
+     * @brief Returns a fresh color, assigned round-robin across the process.
+     */
+    inline size_t next() noexcept
+    {
+        static std::atomic<size_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the byte offset of a color.
+     *
+     * @param color Color of the allocation, reduced modulo colors
+     * @param colors Number of distinct colors
+     * @param step Distance between two adjacent colors, a multiple of lineSize
+     */
+    inline size_t offset(size_t color, size_t colors = defaultColors, size_t step = lineSize) noexcept
+    {
+        return (colors == 0 ? 0 : color % colors) * step;
+    }
+
+    /**
+     * @brief Returns the distance between adjacent colors of objects of type T.
+     *
+     * Objects aligned beyond a line, such as queues padded to SPSCQ_INTERFERENCE_SIZE,
+     * step by their alignment, so every color stays aligned.
+     */
+    template <typename T>
+    inline constexpr size_t step = alignof(T) > lineSize ? alignof(T) : lineSize;
+
+    /**
+     * @brief Returns the number of distinct colors of objects of type T within a page.
+     *
+     * Offsets a page apart map to the same L1 sets, so more colors would only repeat
+     * earlier ones while wasting memory.
+     */
+    template <typename T>
+    inline constexpr size_t colors_of = pageSize / step<T>;
+}
+
+/**
+ * @brief Allocator placing each allocation at a colored offset from a page boundary.
+ *
+ * Every allocation starts exactly offset(color, colors) bytes after a page boundary,
+ * so queues given distinct colors never share the cache sets of their first slots.
+ * Use color 0 (or colors == 1) for plain page-aligned allocations.
+ *
+ * @tparam T The type of elements to allocate, with an alignment of at most lineSize
+ */
+template <typename T>
+class colored_allocator
+{
+public:
+    using value_type = T;
+
+    static_assert(alignof(T) <= cache_color::lineSize, "The type T must not be over-aligned.");
+
+    /**
+     * @param color Color of the allocations, defaults to the next round-robin color
+     * @param colors Number of distinct colors
+     */
+    explicit colored_allocator(size_t color = cache_color::next(), size_t colors = cache_color::defaultColors) noexcept
+        : offset_(cache_color::offset(color, colors))
+    {
+    }
+
+    template <typename U>
+    colored_allocator(const colored_allocator<U> &other) noexcept : offset_(other.offset_) {}
+
+    T *allocate(size_t n)
+    {
+        auto *base = static_cast<std::byte *>(::operator new(n * sizeof(T) + offset_, std::align_val_t(cache_color::pageSize)));
+        return reinterpret_cast<T *>(base + offset_);
+    }
+
+    void deallocate(T *p, size_t) noexcept
+    {
+        ::operator delete(reinterpret_cast<std::byte *>(p) - offset_, std::align_val_t(cache_color::pageSize));
+    }
+
+    /** Returns the byte offset of the allocations from a page boundary */
+    size_t offset() const noexcept { return offset_; }
+
+    template <typename U>
+    bool operator==(const colored_allocator<U> &other) const noexcept { return offset_ == other.offset_; }
+
+    template <typename U>
+    bool operator!=(const colored_allocator<U> &other) const noexcept { return offset_ != other.offset_; }
+
+private:
+    template <typename U>
+    friend class colored_allocator;
+
+    size_t offset_;
+};
+
+/**
+ * @brief Deleter for objects created by make_colored().
+ */
+template <typename T>
+struct colored_delete
+{
+    size_t offset = 0;
+
+    void operator()(T *p) const noexcept
+    {
+        p->~T();
+        ::operator delete(reinterpret_cast<std::byte *>(p) - offset, std::align_val_t(cache_color::pageSize));
+    }
+};
+
+template <typename T>
+using colored_ptr = std::unique_ptr<T, colored_delete<T>>;
+
+/**
+ * @brief Constructs an object at a colored offset from a page boundary.
+ *
+ * Applied to a queue, this staggers its index block the same way colored_allocator
+ * staggers its ring buffer. Colors are cache_color::step<T> bytes apart, which is the
+ * queue's alignment when that exceeds a line, and stay within one page: colors is capped
+ * at cache_color::colors_of<T>, 32 for queues aligned to 128 bytes.
+ *
+ * @param color Color of the object
+ * @param colors Number of distinct colors, capped at cache_color::colors_of<T>
+ * @param args Arguments forwarded to the object's constructor
+ */
+template <typename T, typename... Args>
+colored_ptr<T> make_colored(size_t color, size_t colors, Args &&...args)
+{
+    static_assert(alignof(T) <= cache_color::pageSize, "The type T must not be aligned beyond a page.");
+
+    const size_t distinct = colors < cache_color::colors_of<T> ? colors : cache_color::colors_of<T>;
+    const size_t offset = cache_color::offset(color, distinct, cache_color::step<T>);
+
+    auto *base = static_cast<std::byte *>(::operator new(sizeof(T) + offset, std::align_val_t(cache_color::pageSize)));
+
+    try
+    {
+        return colored_ptr<T>(new (base + offset) T(std::forward<Args>(args)...), colored_delete<T>{offset});
+    }
+    catch (...)
+    {
+        ::operator delete(base, std::align_val_t(cache_color::pageSize));
+        throw;
+    }
+}
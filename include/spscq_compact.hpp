@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief A memory-compact variant of the lock-free SPSC queue.
+ *
+ * spscq places each of its four indices on its own cache line, which costs at least
+ * 256 bytes per queue. That is the right trade-off for a few hot queues, but wastes
+ * memory and last-level cache capacity when thousands of mostly idle queues coexist.
+ *
+ * spscq_compact uses 32-bit indices and packs the storage pointer, the capacity and
+ * both the producer and the consumer state into a single 32-byte block, so two
+ * queues fit in one cache line. The price is false sharing between the producer and
+ * the consumer on every operation, which only matters for queues under heavy traffic.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam Allocator The allocator type used for memory management, defaults to std::allocator<T>
+ *
+ * @note This queue is designed for single-producer single-consumer scenarios only.
+ *       Using multiple producers or consumers will result in undefined behavior.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class alignas(32) spscq_compact : private Allocator
+{
+public:
+    /**
+     * @brief Attempts to construct an element in-place at the back of the queue.
+     *
+     * @tparam Args Parameter pack of argument types for element construction
+     * @param args Arguments forwarded to the element's constructor
+     * @return true if the element was successfully constructed and added to the queue
+     * @return false if the queue was full
+     *
+     * @note This operation is lock-free and can be safely called from the producer thread
+     */
+    template <typename... Args>
+    bool try_emplace(Args &&...args) noexcept(std::is_nothrow_constructible<T, Args &&...>::value)
+    {
+        static_assert(std::is_constructible_v<T, Args...>, "The type T must support construction with the provided arguments.");
+
+        const uint32_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+        const uint32_t nextWriteIdx = increment(writeIdx);
+
+        if (nextWriteIdx == readIdxCached_)
+        {
+            readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+            if (nextWriteIdx == readIdxCached_)
+            {
+                return false;
+            }
+        }
+
+        new (&data_[writeIdx]) T(std::forward<Args>(args)...);
+        writeIdx_.store(nextWriteIdx, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Attempts to add an element to the back of the queue.
+     *
+     * @tparam P Type of the value to push (typically deduced)
+     * @param value Value to push into the queue
+     * @return true if the element was successfully added
+     * @return false if the queue was full
+     *
+     * @note This operation is lock-free and can be safely called from the producer thread
+     */
+    template <typename P>
+    bool try_push(P &&value)
+    {
+        return try_emplace(std::forward<P>(value));
+    }
+
+    /**
+     * @brief Attempts to remove and return the front element of the queue.
+     *
+     * @param value Reference where the removed element will be stored
+     * @return true if an element was successfully removed
+     * @return false if the queue was empty
+     *
+     * @note This operation is lock-free and can be safely called from the consumer thread
+     */
+    bool try_pop(T &value)
+    {
+        const uint32_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        if (readIdx == writeIdxCached_)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+            if (readIdx == writeIdxCached_)
+            {
+                return false;
+            }
+        }
+
+        value = std::move(data_[readIdx]);
+        data_[readIdx].~T();
+
+        readIdx_.store(increment(readIdx), std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the current number of elements in the queue.
+     *
+     * @note The result is a snapshot and may be stale by the time the caller uses it
+     */
+    size_t size() const noexcept
+    {
+        const uint32_t readIdx = readIdx_.load(std::memory_order_acquire);
+        const uint32_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+
+        return writeIdx - readIdx + (writeIdx < readIdx ? size_ : 0);
+    }
+
+    /**
+     * @brief Checks if the queue is empty.
+     *
+     * @note The result may be stale by the time the caller uses it
+     */
+    bool empty() const noexcept
+    {
+        return readIdx_.load(std::memory_order_relaxed) == writeIdx_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Constructs a new compact SPSC queue with the specified capacity.
+     *
+     * @param size The maximum capacity of the queue (actual capacity will be size-1)
+     * @param alloc The allocator instance to use for memory allocation
+     * @throws std::invalid_argument if size is 0 or does not fit in 32 bits
+     * @throws std::bad_alloc if memory allocation fails
+     */
+    explicit spscq_compact(size_t size, const Allocator &alloc = Allocator()) : Allocator(alloc)
+    {
+        if (size == 0)
+        {
+            throw std::invalid_argument("Queue size must be greater than 0");
+        }
+
+        if (size > UINT32_MAX)
+        {
+            throw std::invalid_argument("Queue size must fit in 32 bits");
+        }
+
+        size_ = static_cast<uint32_t>(size);
+        data_ = Allocator::allocate(size_);
+    }
+
+    /**
+     * @brief Destroys the queue and all contained elements.
+     *
+     * @note This operation is not thread-safe and should only be called
+     *       when no other threads are accessing the queue
+     */
+    ~spscq_compact() noexcept
+    {
+        uint32_t r = readIdx_.load(std::memory_order_relaxed);
+        uint32_t w = writeIdx_.load(std::memory_order_relaxed);
+
+        while (r != w)
+        {
+            data_[r].~T();
+            r = increment(r);
+        }
+
+        Allocator::deallocate(data_, size_);
+    }
+
+    spscq_compact(const spscq_compact &) = delete;
+    spscq_compact &operator=(const spscq_compact &) = delete;
+
+private:
+    uint32_t increment(uint32_t index) const noexcept
+    {
+        uint32_t nextIdx = index + 1;
+        return (nextIdx == size_) ? 0 : nextIdx;
+    }
+
+    /** Pointer to the allocated storage for queue elements */
+    T *data_;
+
+    /** Size of the allocated storage (actual capacity is size_ - 1) */
+    uint32_t size_;
+
+    /**
+     * Producer state: the published write index and the producer's cache of the read index.
+     * Consumer state: the published read index and the consumer's cache of the write index.
+     * All four share the queue's single cache line with the storage pointer and capacity.
+     */
+    std::atomic<uint32_t> writeIdx_{0};
+    uint32_t readIdxCached_ = 0;
+    std::atomic<uint32_t> readIdx_{0};
+    uint32_t writeIdxCached_ = 0;
+};
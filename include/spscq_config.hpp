@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Distance in bytes that separates data written by different threads.
+ *
+ * Every spscq header pads the state of one side away from the other side by this many
+ * bytes. The default of 128 covers two 64-byte lines: Intel cores since Sandy Bridge
+ * fetch lines in adjacent pairs (the spatial prefetcher), so two writers 64 bytes apart
+ * still ping-pong the same 128-byte block, and Apple and some Arm cores use 128-byte
+ * lines outright.
+ *
+ * std::hardware_destructive_interference_size is deliberately not used: its value
+ * depends on -march/-mtune, so two translation units built with different flags would
+ * disagree on the layout of the same queue. This value only changes when the macro is
+ * set, which the CMake target does consistently for all its users (option
+ * SPSCQ_INTERFERENCE_SIZE). Run interference_bench to measure the distance on a host.
+ */
+#ifndef SPSCQ_INTERFERENCE_SIZE
+#define SPSCQ_INTERFERENCE_SIZE 128
+#endif
+
+namespace spscq_config
+{
+    /** Alignment used to keep producer-owned and consumer-owned state apart */
+    inline constexpr size_t interferenceSize = SPSCQ_INTERFERENCE_SIZE;
+
+    static_assert(interferenceSize >= alignof(std::max_align_t) && (interferenceSize & (interferenceSize - 1)) == 0,
+                  "SPSCQ_INTERFERENCE_SIZE must be a power of two no smaller than alignof(std::max_align_t).");
+}
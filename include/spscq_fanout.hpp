@@ -0,0 +1,239 @@
+#pragma once
+
+#include "spscq.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Parallel fan-out/fan-in over worker threads that preserves submission order.
+ *
+ * The producer thread submits items, which are tagged with a sequence number and
+ * handed to the next worker with room in its input spscq. Each worker thread applies
+ * the transform and pushes the result, still tagged, to its own output spscq. The
+ * consumer thread collects results from all output queues into a reorder buffer and
+ * releases them strictly in submission order.
+ *
+ * Memory stays bounded: at most `window` items are in flight between submission and
+ * release, so the reorder buffer never holds more than `window` results. When one
+ * worker stalls, the consumer cannot release past its item, the window fills up and
+ * try_submit() starts failing, pushing back on the producer.
+ *
+ * @tparam In The type of items submitted by the producer
+ * @tparam Out The type of results released to the consumer
+ *
+ * @note try_submit() must only be called from one producer thread and try_receive()
+ *       from one consumer thread; the transform is called concurrently from all workers.
+ */
+template <typename In, typename Out>
+class spscq_fanout
+{
+public:
+    using transform_type = std::function<Out(In)>;
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param workers Number of worker threads
+     * @param size Size of each worker's input and output queue (actual capacity will be size-1)
+     * @param window Maximum number of items in flight, and size of the reorder buffer
+     * @param transform Function applied to each item by the workers
+     * @throws std::invalid_argument if workers, size or window is 0
+     */
+    spscq_fanout(size_t workers, size_t size, size_t window, transform_type transform)
+        : transform_(std::move(transform)), window_(window), reorder_(window)
+    {
+        if (workers == 0 || window == 0)
+        {
+            throw std::invalid_argument("Fan-out must have at least one worker and a non-empty window");
+        }
+
+        for (size_t w = 0; w < workers; ++w)
+        {
+            inputs_.push_back(std::make_unique<spscq<task>>(size));
+            outputs_.push_back(std::make_unique<spscq<task_result>>(size));
+        }
+
+        for (size_t w = 0; w < workers; ++w)
+        {
+            threads_.emplace_back([this, w]() { run(w); });
+        }
+    }
+
+    /**
+     * @brief Stops and joins the worker threads.
+     *
+     * Items still in flight are discarded.
+     */
+    ~spscq_fanout() noexcept
+    {
+        stop_.store(true, std::memory_order_relaxed);
+        for (auto &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    spscq_fanout(const spscq_fanout &) = delete;
+    spscq_fanout &operator=(const spscq_fanout &) = delete;
+
+    /**
+     * @brief Attempts to submit an item to the workers.
+     *
+     * @param item Item to transform
+     * @return true if the item was handed to a worker
+     * @return false if the window is full or every worker's input queue is full
+     *
+     * @note Must only be called from the producer thread
+     */
+    template <typename P>
+    bool try_submit(P &&item)
+    {
+        if (nextSeq_ - releasedCached_ >= window_)
+        {
+            releasedCached_ = released_.load(std::memory_order_acquire);
+            if (nextSeq_ - releasedCached_ >= window_)
+            {
+                return false;
+            }
+        }
+
+        const size_t workers = inputs_.size();
+        for (size_t i = 0; i < workers; ++i)
+        {
+            const size_t w = nextWorker_;
+            nextWorker_ = (nextWorker_ + 1 == workers) ? 0 : nextWorker_ + 1;
+
+            // A failed try_emplace leaves its argument untouched, so forwarding again is safe
+            if (inputs_[w]->try_emplace(nextSeq_, std::forward<P>(item)))
+            {
+                ++nextSeq_;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Attempts to release the next result in submission order.
+     *
+     * @param value Reference where the result will be stored
+     * @return true if a result was released
+     * @return false if the next result in order is not available yet
+     *
+     * @note Must only be called from the consumer thread
+     */
+    bool try_receive(Out &value)
+    {
+        std::optional<Out> &slot = reorder_[nextRelease_ % window_];
+
+        if (!slot)
+        {
+            collect();
+            if (!slot)
+            {
+                return false;
+            }
+        }
+
+        value = std::move(*slot);
+        slot.reset();
+
+        released_.store(++nextRelease_, std::memory_order_release);
+        return true;
+    }
+
+    /** Returns the number of worker threads */
+    size_t workers() const noexcept { return threads_.size(); }
+
+private:
+    /** An item or a result tagged with its submission sequence number */
+    template <typename V>
+    struct sequenced
+    {
+        template <typename P>
+        sequenced(uint64_t seq, P &&value) : seq(seq), value(std::forward<P>(value)) {}
+
+        uint64_t seq;
+        V value;
+    };
+
+    using task = sequenced<In>;
+    using task_result = sequenced<Out>;
+
+    /**
+     * @brief Moves every available result into its reorder buffer slot.
+     */
+    void collect()
+    {
+        for (auto &output : outputs_)
+        {
+            for (task_result &result : output->drain())
+            {
+                reorder_[result.seq % window_].emplace(std::move(result.value));
+            }
+        }
+    }
+
+    /**
+     * @brief Worker loop: transforms items from input queue w into output queue w.
+     */
+    void run(size_t w)
+    {
+        spscq<task> &input = *inputs_[w];
+        spscq<task_result> &output = *outputs_[w];
+
+        while (!stop_.load(std::memory_order_relaxed))
+        {
+            task *item = input.front();
+            if (item == nullptr)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const uint64_t seq = item->seq;
+            Out result = transform_(std::move(item->value));
+            input.pop();
+
+            while (!output.try_emplace(seq, std::move(result)))
+            {
+                if (stop_.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    transform_type transform_;
+    size_t window_;
+
+    std::vector<std::unique_ptr<spscq<task>>> inputs_;
+    std::vector<std::unique_ptr<spscq<task_result>>> outputs_;
+    std::vector<std::thread> threads_;
+
+    /** Producer-private state: next sequence number, next worker and cache of released_ */
+    alignas(spscq_config::interferenceSize) uint64_t nextSeq_ = 0;
+    size_t nextWorker_ = 0;
+    uint64_t releasedCached_ = 0;
+
+    /** Consumer-private state: sequence number of the next result to release */
+    alignas(spscq_config::interferenceSize) uint64_t nextRelease_ = 0;
+    std::vector<std::optional<Out>> reorder_;
+
+    /** Number of results released so far, published by the consumer for back-pressure */
+    alignas(spscq_config::interferenceSize) std::atomic<uint64_t> released_{0};
+
+    /** Set on destruction to stop the workers, polled by every worker */
+    alignas(spscq_config::interferenceSize) std::atomic<bool> stop_{false};
+};
@@ -0,0 +1,306 @@
+#pragma once
+
+#include "spscq.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Timestamp-ordered k-way merge over several spscq inputs.
+ *
+ * Each input queue must deliver its own elements in non-decreasing key order. The merge
+ * peeks the head of every input and emits the globally smallest key, using a winner
+ * tournament tree so that each emitted element costs O(log K) comparisons. Elements
+ * are handed to the caller in place in the input ring and are never copied.
+ *
+ * An empty input does not simply drop out of the tournament: it competes with its
+ * watermark, a lower bound on the key of anything it will deliver in the future. When
+ * an empty input wins, nothing can be emitted without risking reordering, so the merge
+ * stalls until that input delivers an element, its watermark is raised, or it is closed.
+ * An input's watermark starts unknown and advances automatically to the key of each
+ * element emitted from it; set_watermark() raises it explicitly (e.g. on heartbeats).
+ *
+ * @tparam T The type of elements stored in the input queues
+ * @tparam KeyOf Callable returning the ordering key of an element, e.g. its timestamp
+ * @tparam Allocator The allocator type of the input queues
+ *
+ * @note All member functions must be called from the thread consuming the inputs
+ */
+template <typename T, typename KeyOf, typename Allocator = std::allocator<T>>
+class spscq_merge
+{
+public:
+    using queue_type = spscq<T, Allocator>;
+    using key_type = std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>;
+
+    /**
+     * @brief Constructs a merge over the given input queues.
+     *
+     * @param inputs The input queues, in the order used to identify them
+     * @param keyOf Callable extracting the key of an element
+     * @throws std::invalid_argument if inputs is empty
+     */
+    explicit spscq_merge(std::vector<queue_type *> inputs, KeyOf keyOf = KeyOf())
+        : keyOf_(std::move(keyOf)), count_(inputs.size())
+    {
+        if (inputs.empty())
+        {
+            throw std::invalid_argument("Merge must have at least one input");
+        }
+
+        leaves_ = 1;
+        while (leaves_ < inputs.size())
+        {
+            leaves_ *= 2;
+        }
+
+        inputs_.resize(leaves_);
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            inputs_[i].queue = inputs[i];
+            inputs_[i].state = status::unknown;
+        }
+
+        tree_.resize(2 * leaves_);
+        for (size_t i = 0; i < leaves_; ++i)
+        {
+            tree_[leaves_ + i] = i;
+        }
+        for (size_t n = leaves_ - 1; n > 0; --n)
+        {
+            tree_[n] = winner(tree_[2 * n], tree_[2 * n + 1]);
+        }
+    }
+
+    /**
+     * @brief Emits the element with the globally smallest key, if it is safe to do so.
+     *
+     * Calls f(input, element) with a reference to the element in its input ring, then
+     * removes it from the input.
+     *
+     * @param f Callable invoked as f(size_t input, T &element)
+     * @return true if an element was emitted
+     * @return false if the winning input is empty and may still deliver a smaller key,
+     *         or if every input is closed and drained
+     */
+    template <typename F>
+    bool try_emit(F &&f)
+    {
+        for (;;)
+        {
+            const size_t w = tree_[1];
+            input &in = inputs_[w];
+
+            if (in.state == status::head)
+            {
+                f(w, *in.head);
+
+                in.watermark = std::move(in.key);
+                in.hasWatermark = true;
+                in.queue->pop();
+                refresh(w);
+                replay(w);
+                return true;
+            }
+
+            if (in.state == status::closed || !refresh(w))
+            {
+                return false;
+            }
+
+            replay(w);
+        }
+    }
+
+    /**
+     * @brief Emits elements until nothing more can be emitted safely.
+     *
+     * @param f Callable invoked as f(size_t input, T &element)
+     * @return size_t Number of elements emitted
+     */
+    template <typename F>
+    size_t emit_all(F &&f)
+    {
+        size_t count = 0;
+        while (try_emit(f))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Raises the watermark of an input.
+     *
+     * Promises that every element the input delivers from now on has a key not smaller
+     * than the watermark. Watermarks lower than the current one are ignored.
+     *
+     * @param i Index of the input
+     * @param watermark New lower bound on the input's future keys
+     */
+    void set_watermark(size_t i, key_type watermark)
+    {
+        input &in = inputs_[i];
+
+        if (in.hasWatermark && !(in.watermark < watermark))
+        {
+            return;
+        }
+
+        in.watermark = std::move(watermark);
+        in.hasWatermark = true;
+
+        if (in.state == status::unknown || in.state == status::watermark)
+        {
+            in.key = in.watermark;
+            in.state = status::watermark;
+            replay(i);
+        }
+    }
+
+    /**
+     * @brief Marks an input as finished.
+     *
+     * Elements already in the input are still emitted; once it is drained the input
+     * no longer holds back the merge.
+     *
+     * @param i Index of the input
+     */
+    void close(size_t i)
+    {
+        inputs_[i].closed = true;
+        if (inputs_[i].state != status::head)
+        {
+            refresh(i);
+            replay(i);
+        }
+    }
+
+    /** Returns the number of inputs */
+    size_t inputs() const noexcept { return count_; }
+
+private:
+    /**
+     * State of an input in the tournament, ordered by how it ranks for equal keys.
+     *
+     * unknown: empty with no watermark yet, ranks below any key
+     * head: key is the key of the element at the head of the queue
+     * watermark: empty, key is the lower bound of future elements
+     * closed: drained and finished, ranks above any key
+     */
+    enum class status
+    {
+        unknown,
+        head,
+        watermark,
+        closed
+    };
+
+    /**
+     * Per-input tournament entry.
+     *
+     * key: the key the input competes with, the head's key or the watermark depending on state
+     * watermark: lower bound on the keys the input will deliver, valid if hasWatermark
+     */
+    struct input
+    {
+        queue_type *queue = nullptr;
+        T *head = nullptr;
+        key_type key{};
+        key_type watermark{};
+        status state = status::closed;
+        bool hasWatermark = false;
+        bool closed = false;
+    };
+
+    /**
+     * @brief Re-reads the head of an input and updates its tournament entry.
+     *
+     * @return true if the input no longer blocks the merge (it has a head or is closed)
+     */
+    bool refresh(size_t i)
+    {
+        input &in = inputs_[i];
+        in.head = in.queue->front();
+
+        if (in.head != nullptr)
+        {
+            in.key = keyOf_(*in.head);
+            in.state = status::head;
+            return true;
+        }
+
+        if (in.closed)
+        {
+            in.state = status::closed;
+            return true;
+        }
+
+        if (in.hasWatermark)
+        {
+            in.key = in.watermark;
+            in.state = status::watermark;
+        }
+        else
+        {
+            in.state = status::unknown;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the index of the input that must be emitted first.
+     */
+    size_t winner(size_t a, size_t b) const
+    {
+        const input &x = inputs_[a];
+        const input &y = inputs_[b];
+
+        if (x.state == status::unknown || y.state == status::closed)
+        {
+            return a;
+        }
+        if (y.state == status::unknown || x.state == status::closed)
+        {
+            return b;
+        }
+        if (x.key < y.key)
+        {
+            return a;
+        }
+        if (y.key < x.key)
+        {
+            return b;
+        }
+        return y.state < x.state ? b : a;
+    }
+
+    /**
+     * @brief Replays the matches on the path from a leaf to the root.
+     */
+    void replay(size_t i)
+    {
+        for (size_t n = (leaves_ + i) / 2; n > 0; n /= 2)
+        {
+            tree_[n] = winner(tree_[2 * n], tree_[2 * n + 1]);
+        }
+    }
+
+    KeyOf keyOf_;
+
+    /** Number of inputs */
+    size_t count_;
+
+    /** Number of leaves of the tree, the number of inputs rounded up to a power of two */
+    size_t leaves_;
+
+    /** Per-input state, padded with closed inputs up to leaves_ */
+    std::vector<input> inputs_;
+
+    /** Winner tree: tree_[1] is the overall winner, tree_[leaves_ + i] is input i */
+    std::vector<size_t> tree_;
+};
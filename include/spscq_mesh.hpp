@@ -0,0 +1,236 @@
+#pragma once
+
+#include "spscq.hpp"
+#include "spscq_arena.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief An all-to-all mesh of SPSC channels between N worker threads.
+ *
+ * Every ordered pair of distinct workers gets a dedicated spscq, for N*(N-1) channels
+ * in total. All channels, control blocks and ring buffers alike, are carved out of a
+ * single huge-page-backed spscq_arena instead of N*(N-1) scattered heap allocations.
+ *
+ * The arena is laid out by consumer: the control blocks of a worker's inbound channels
+ * are contiguous, followed by their ring buffers, so poll_all() walks adjacent memory.
+ * Each ring buffer starts on an SPSCQ_INTERFERENCE_SIZE boundary, so the tail of one
+ * producer's ring never shares a line with the head of the next one.
+ *
+ * Each worker talks to the mesh through its endpoint: send() on the endpoint only
+ * touches channels the worker produces into and poll_all() only channels it consumes.
+ *
+ * @tparam T The type of messages exchanged between workers
+ */
+template <typename T>
+class spscq_mesh
+{
+public:
+    using queue_type = spscq<T, arena_allocator<T>>;
+
+    /**
+     * @brief Per-worker view of the mesh.
+     *
+     * @note An endpoint must only be used from the thread of the worker it belongs to
+     */
+    class endpoint
+    {
+    public:
+        /**
+         * @brief Attempts to send a message to another worker.
+         *
+         * @param to Index of the destination worker, must differ from this worker
+         * @param msg Message to send
+         * @return true if the message was enqueued
+         * @return false if the channel to the destination was full
+         */
+        template <typename P>
+        bool try_send(size_t to, P &&msg)
+        {
+            return mesh_->channel(self_, to).try_push(std::forward<P>(msg));
+        }
+
+        /**
+         * @brief Sends a message to another worker, spinning while the channel is full.
+         *
+         * @param to Index of the destination worker, must differ from this worker
+         * @param msg Message to send
+         */
+        template <typename P>
+        void send(size_t to, P &&msg)
+        {
+            queue_type &queue = mesh_->channel(self_, to);
+
+            // A failed try_push leaves its argument untouched, so forwarding again is safe
+            while (!queue.try_push(std::forward<P>(msg)))
+                ;
+        }
+
+        /**
+         * @brief Drains every inbound channel of this worker.
+         *
+         * Calls f(from, message) for each available message, where message is a
+         * reference to the element in the ring. Each channel publishes its read index
+         * once per drained batch.
+         *
+         * @param f Callable invoked as f(size_t from, T &message)
+         * @return size_t Number of messages processed
+         */
+        template <typename F>
+        size_t poll_all(F &&f)
+        {
+            size_t count = 0;
+            queue_type *inbound = mesh_->inbound(self_);
+
+            for (size_t k = 0; k + 1 < mesh_->workers_; ++k)
+            {
+                const size_t from = k < self_ ? k : k + 1;
+                for (T &msg : inbound[k].drain())
+                {
+                    f(from, msg);
+                    ++count;
+                }
+            }
+
+            return count;
+        }
+
+        /** Index of the worker this endpoint belongs to */
+        size_t id() const noexcept { return self_; }
+
+    private:
+        friend class spscq_mesh;
+
+        endpoint(spscq_mesh &mesh, size_t self) noexcept : mesh_(&mesh), self_(self) {}
+
+        spscq_mesh *mesh_;
+        size_t self_;
+    };
+
+    /**
+     * @brief Allocates all channels of the mesh from one arena.
+     *
+     * @param workers Number of workers, at least 2
+     * @param size Size of each channel (actual capacity will be size-1)
+     * @throws std::invalid_argument if workers is less than 2 or size is 0
+     * @throws std::bad_alloc if the arena cannot be mapped
+     */
+    spscq_mesh(size_t workers, size_t size)
+        : workers_(validate(workers, size)), arena_(arena_size(workers, size))
+    {
+        const size_t perConsumer = workers_ - 1;
+        inbound_ = static_cast<queue_type **>(arena_.allocate(workers_ * sizeof(queue_type *), alignof(queue_type *)));
+
+        // Queues built before a failure are destroyed by the catch below, since the
+        // destructor does not run for a partially constructed mesh
+        size_t built = 0;
+        try
+        {
+            for (size_t c = 0; c < workers_; ++c)
+            {
+                inbound_[c] = static_cast<queue_type *>(arena_.allocate(perConsumer * sizeof(queue_type), alignof(queue_type)));
+                for (size_t k = 0; k < perConsumer; ++k)
+                {
+                    new (&inbound_[c][k]) queue_type(size, arena_allocator<T>(arena_, spscq_config::interferenceSize));
+                    ++built;
+                }
+            }
+        }
+        catch (...)
+        {
+            while (built-- != 0)
+            {
+                inbound_[built / perConsumer][built % perConsumer].~queue_type();
+            }
+            throw;
+        }
+    }
+
+    ~spscq_mesh() noexcept
+    {
+        for (size_t c = 0; c < workers_; ++c)
+        {
+            for (size_t k = 0; k + 1 < workers_; ++k)
+            {
+                inbound_[c][k].~queue_type();
+            }
+        }
+    }
+
+    spscq_mesh(const spscq_mesh &) = delete;
+    spscq_mesh &operator=(const spscq_mesh &) = delete;
+
+    /**
+     * @brief Returns the endpoint of a worker.
+     *
+     * @param self Index of the worker, less than workers()
+     */
+    endpoint worker(size_t self) noexcept
+    {
+        return endpoint(*this, self);
+    }
+
+    /**
+     * @brief Returns the channel carrying messages from one worker to another.
+     *
+     * @param from Index of the producing worker
+     * @param to Index of the consuming worker, must differ from from
+     */
+    queue_type &channel(size_t from, size_t to) noexcept
+    {
+        return inbound_[to][from < to ? from : from - 1];
+    }
+
+    /** Returns the number of workers */
+    size_t workers() const noexcept { return workers_; }
+
+    /** Returns the arena backing all channels */
+    const spscq_arena &arena() const noexcept { return arena_; }
+
+private:
+    /**
+     * @brief Checks the mesh arguments before the arena is mapped.
+     *
+     * @return size_t The number of workers
+     * @throws std::invalid_argument if workers is less than 2 or size is 0
+     */
+    static size_t validate(size_t workers, size_t size)
+    {
+        if (workers < 2)
+        {
+            throw std::invalid_argument("Mesh must have at least 2 workers");
+        }
+
+        if (size == 0)
+        {
+            throw std::invalid_argument("Queue size must be greater than 0");
+        }
+
+        return workers;
+    }
+
+    /**
+     * @brief Computes an upper bound of the arena size needed by the mesh.
+     */
+    static size_t arena_size(size_t workers, size_t size) noexcept
+    {
+        const size_t channels = workers * (workers - 1);
+        const size_t control = workers * (sizeof(queue_type *) + alignof(queue_type)) + channels * sizeof(queue_type);
+        const size_t buffers = channels * (size * sizeof(T) + spscq_config::interferenceSize);
+
+        return alignof(queue_type *) + control + buffers;
+    }
+
+    queue_type *inbound(size_t self) noexcept
+    {
+        return inbound_[self];
+    }
+
+    size_t workers_;
+    spscq_arena arena_;
+
+    /** For each consumer, the contiguous array of its workers-1 inbound channels */
+    queue_type **inbound_;
+};
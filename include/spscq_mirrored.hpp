@@ -0,0 +1,326 @@
+#pragma once
+
+#include "spscq_config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief A buffer whose pages are mapped twice, back to back, in virtual memory.
+ *
+ * The same memfd pages back [base, base + size) and [base + size, base + 2 * size), so
+ * a byte written at offset i is also visible at offset i + size. Any window of up to
+ * size bytes starting inside the first mapping is therefore contiguous, even when it
+ * runs past the end of the ring.
+ */
+class mirrored_buffer
+{
+public:
+    /**
+     * @brief Maps a mirrored buffer of at least the given size.
+     *
+     * @param bytes Minimum size in bytes, rounded up to a multiple of the page size
+     * @throws std::bad_alloc if the memory cannot be created or mapped
+     */
+    explicit mirrored_buffer(size_t bytes)
+    {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_ = (bytes + page - 1) / page * page;
+        if (size_ == 0)
+        {
+            size_ = page;
+        }
+
+        const int fd = memfd_create("spscq_mirrored", MFD_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::bad_alloc();
+        }
+
+        if (ftruncate(fd, static_cast<off_t>(size_)) != 0)
+        {
+            close(fd);
+            throw std::bad_alloc();
+        }
+
+        // Reserve twice the size, then map the same pages over both halves
+        void *base = mmap(nullptr, 2 * size_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            close(fd);
+            throw std::bad_alloc();
+        }
+
+        base_ = static_cast<std::byte *>(base);
+
+        const bool mapped =
+            mmap(base_, size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+            mmap(base_ + size_, size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+
+        close(fd);
+
+        if (!mapped)
+        {
+            munmap(base_, 2 * size_);
+            throw std::bad_alloc();
+        }
+    }
+
+    ~mirrored_buffer() noexcept
+    {
+        munmap(base_, 2 * size_);
+    }
+
+    mirrored_buffer(const mirrored_buffer &) = delete;
+    mirrored_buffer &operator=(const mirrored_buffer &) = delete;
+
+    /** Returns the start of the first mapping */
+    std::byte *data() const noexcept { return base_; }
+
+    /** Returns the size of one mapping in bytes */
+    size_t size() const noexcept { return size_; }
+
+private:
+    std::byte *base_;
+    size_t size_;
+};
+
+/**
+ * @brief An SPSC ring over a mirrored_buffer, where every window is contiguous.
+ *
+ * With a regular ring, bulk and span operations must split at the wrap point into two
+ * segments, and variable-length records need padding at the end of the buffer. Here
+ * the ring is mapped twice back to back, so the free space seen by the producer and
+ * the data seen by the consumer are always a single contiguous span: batch copies are
+ * one memcpy, SIMD kernels get one run, and byte records are never split.
+ *
+ * Indices are free-running and the capacity is a power of two spanning whole pages,
+ * so every slot is usable.
+ *
+ * @tparam T The type of elements, trivially copyable with a power-of-two size
+ *
+ * @note This queue is designed for single-producer single-consumer scenarios only.
+ */
+template <typename T>
+class spscq_mirrored
+{
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "The type T must be trivially copyable.");
+    static_assert((sizeof(T) & (sizeof(T) - 1)) == 0, "The size of T must be a power of two.");
+
+    /**
+     * @brief Constructs a mirrored queue.
+     *
+     * @param capacity Minimum number of elements, rounded up to a power of two of at least one page
+     * @throws std::invalid_argument if capacity is 0
+     * @throws std::bad_alloc if the buffer cannot be mapped
+     */
+    explicit spscq_mirrored(size_t capacity) : buffer_(bytes_for(capacity))
+    {
+        data_ = reinterpret_cast<T *>(buffer_.data());
+        mask_ = buffer_.size() / sizeof(T) - 1;
+    }
+
+    /**
+     * @brief Returns the contiguous free space available to the producer.
+     *
+     * The consumer's index is only re-read when fewer than wanted slots appear free,
+     * so the window may be smaller than the actual free space.
+     *
+     * @param wanted Number of free slots below which the consumer's index is re-read
+     * @return std::pair<T *, size_t> Pointer to the first free slot and number of free slots
+     *
+     * @note Must only be called from the producer thread
+     */
+    std::pair<T *, size_t> write_window(size_t wanted = 1) noexcept
+    {
+        const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+
+        if (capacity() - (writeIdx - readIdxCached_) < wanted)
+        {
+            readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+        }
+
+        return {&data_[writeIdx & mask_], capacity() - (writeIdx - readIdxCached_)};
+    }
+
+    /**
+     * @brief Publishes n elements written into the last write window.
+     *
+     * @note Must only be called from the producer thread, with n not larger than the window
+     */
+    void commit_write(size_t n) noexcept
+    {
+        writeIdx_.store(writeIdx_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    /**
+     * @brief Returns the contiguous data available to the consumer.
+     *
+     * The producer's index is only re-read when fewer than wanted elements appear
+     * available, so the window may be smaller than the actual data.
+     *
+     * @param wanted Number of elements below which the producer's index is re-read
+     * @return std::pair<T *, size_t> Pointer to the first element and number of elements
+     *
+     * @note Must only be called from the consumer thread
+     */
+    std::pair<T *, size_t> read_window(size_t wanted = 1) noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        if (writeIdxCached_ - readIdx < wanted)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+        }
+
+        return {&data_[readIdx & mask_], writeIdxCached_ - readIdx};
+    }
+
+    /**
+     * @brief Releases n elements from the front of the last read window.
+     *
+     * @note Must only be called from the consumer thread, with n not larger than the window
+     */
+    void commit_read(size_t n) noexcept
+    {
+        readIdx_.store(readIdx_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    /**
+     * @brief Attempts to add an element to the back of the queue.
+     *
+     * @return false if the queue was full
+     */
+    bool try_push(const T &value) noexcept
+    {
+        return try_push_n(&value, 1) == 1;
+    }
+
+    /**
+     * @brief Copies as many elements as fit with a single memcpy and publishes them.
+     *
+     * @return size_t Number of elements added
+     */
+    size_t try_push_n(const T *values, size_t count) noexcept
+    {
+        const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+
+        if (capacity() - (writeIdx - readIdxCached_) < count)
+        {
+            readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+        }
+
+        const size_t free = capacity() - (writeIdx - readIdxCached_);
+        const size_t n = free < count ? free : count;
+        if (n != 0)
+        {
+            std::memcpy(&data_[writeIdx & mask_], values, n * sizeof(T));
+            writeIdx_.store(writeIdx + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Attempts to remove the front element of the queue.
+     *
+     * @return false if the queue was empty
+     */
+    bool try_pop(T &value) noexcept
+    {
+        return try_pop_n(&value, 1) == 1;
+    }
+
+    /**
+     * @brief Copies out up to maxCount elements with a single memcpy and releases them.
+     *
+     * @return size_t Number of elements removed
+     */
+    size_t try_pop_n(T *values, size_t maxCount) noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        if (writeIdxCached_ - readIdx < maxCount)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+        }
+
+        const size_t available = writeIdxCached_ - readIdx;
+        const size_t n = available < maxCount ? available : maxCount;
+        if (n != 0)
+        {
+            std::memcpy(values, &data_[readIdx & mask_], n * sizeof(T));
+            readIdx_.store(readIdx + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /** Returns the number of elements the queue can hold */
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    /**
+     * @brief Returns the current number of elements in the queue.
+     *
+     * @note The result is a snapshot and may be stale by the time the caller uses it
+     */
+    size_t size() const noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_acquire);
+        return writeIdx_.load(std::memory_order_relaxed) - readIdx;
+    }
+
+    /**
+     * @brief Checks if the queue is empty.
+     *
+     * @note The result may be stale by the time the caller uses it
+     */
+    bool empty() const noexcept { return size() == 0; }
+
+    spscq_mirrored(const spscq_mirrored &) = delete;
+    spscq_mirrored &operator=(const spscq_mirrored &) = delete;
+
+private:
+    static size_t bytes_for(size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("Queue capacity must be greater than 0");
+        }
+
+        // Page sizes are powers of two, so a power-of-two byte size of at least one page
+        // maps to a power-of-two element count
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t bytes = page;
+        while (bytes < capacity * sizeof(T))
+        {
+            bytes *= 2;
+        }
+        return bytes;
+    }
+
+    mirrored_buffer buffer_;
+    T *data_;
+    size_t mask_;
+
+    /**
+     * Free-running indices, each on its own cache line as in spscq.
+     *
+     * readIdx_: Position the consumer reads from
+     * readIdxCached_: Producer's cache of the consumer's read position
+     * writeIdx_: Position the producer writes to
+     * writeIdxCached_: Consumer's cache of the producer's write position
+     */
+    alignas(spscq_config::interferenceSize) std::atomic<size_t> readIdx_{0};
+    alignas(spscq_config::interferenceSize) size_t readIdxCached_ = 0;
+    alignas(spscq_config::interferenceSize) std::atomic<size_t> writeIdx_{0};
+    alignas(spscq_config::interferenceSize) size_t writeIdxCached_ = 0;
+};
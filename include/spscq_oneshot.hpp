@@ -0,0 +1,306 @@
+#pragma once
+
+#include "spscq_config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define SPSCQ_ONESHOT_COROUTINES 1
+#endif
+
+/**
+ * @brief A single-use channel carrying one value from a sender to a receiver.
+ *
+ * Replaces a capacity-2 spscq or a std::promise/std::future pair for request/response
+ * handoffs: the value is stored inline and all synchronization goes through a single
+ * 32-bit atomic state word, with no heap allocation and no mutex.
+ *
+ * The receiver can wait by spinning, by sleeping on the state word with a futex, or,
+ * when compiled as C++20, by co_await-ing the channel. Receiving moves the value out
+ * and returns the channel to its empty state, so channels can be recycled through an
+ * spscq_oneshot_pool without any allocation in steady state.
+ *
+ * @tparam T The type of the value carried by the channel
+ *
+ * @note Exactly one sender and one receiver may use the channel per round trip
+ */
+template <typename T>
+class alignas(spscq_config::interferenceSize) spscq_oneshot
+{
+public:
+    spscq_oneshot() noexcept = default;
+
+    /**
+     * @brief Destroys the value if it was sent but never received.
+     */
+    ~spscq_oneshot() noexcept
+    {
+        reset();
+    }
+
+    spscq_oneshot(const spscq_oneshot &) = delete;
+    spscq_oneshot &operator=(const spscq_oneshot &) = delete;
+
+    /**
+     * @brief Constructs the value in place and hands it to the receiver.
+     *
+     * Wakes the receiver if it sleeps on the futex, or resumes its coroutine on the
+     * calling thread if it awaits the channel.
+     *
+     * @param args Arguments forwarded to the value's constructor
+     *
+     * @note Must be called at most once per round trip, from the sender thread
+     */
+    template <typename... Args>
+    void send(Args &&...args) noexcept(std::is_nothrow_constructible<T, Args &&...>::value)
+    {
+        new (&storage_) T(std::forward<Args>(args)...);
+
+        const uint32_t previous = state_.exchange(ready, std::memory_order_acq_rel);
+
+        if (previous == sleeping)
+        {
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&state_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+#ifdef SPSCQ_ONESHOT_COROUTINES
+        else if (previous == awaiting)
+        {
+            std::coroutine_handle<>::from_address(continuation_).resume();
+        }
+#endif
+    }
+
+    /**
+     * @brief Checks whether the value has been sent.
+     */
+    bool is_ready() const noexcept
+    {
+        return state_.load(std::memory_order_acquire) == ready;
+    }
+
+    /**
+     * @brief Attempts to receive the value without waiting.
+     *
+     * @param value Reference where the value will be moved
+     * @return true if the value was received
+     * @return false if it has not been sent yet
+     */
+    bool try_receive(T &value)
+    {
+        if (!is_ready())
+        {
+            return false;
+        }
+
+        value = take();
+        return true;
+    }
+
+    /**
+     * @brief Receives the value, spinning until it is sent.
+     */
+    T receive_spin()
+    {
+        while (!is_ready())
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        }
+
+        return take();
+    }
+
+    /**
+     * @brief Receives the value, sleeping on the state word until it is sent.
+     */
+    T receive_futex()
+    {
+        uint32_t state = state_.load(std::memory_order_acquire);
+
+        while (state != ready)
+        {
+            if (state == empty && !state_.compare_exchange_weak(state, sleeping, std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&state_), FUTEX_WAIT_PRIVATE, sleeping, nullptr, nullptr, 0);
+            state = state_.load(std::memory_order_acquire);
+        }
+
+        return take();
+    }
+
+#ifdef SPSCQ_ONESHOT_COROUTINES
+    /**
+     * @brief Awaitable returned by operator co_await.
+     */
+    class awaiter
+    {
+    public:
+        bool await_ready() const noexcept { return channel_->is_ready(); }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            channel_->continuation_ = handle.address();
+
+            uint32_t expected = empty;
+            return channel_->state_.compare_exchange_strong(expected, awaiting, std::memory_order_release, std::memory_order_acquire);
+        }
+
+        T await_resume() { return channel_->take(); }
+
+    private:
+        friend class spscq_oneshot;
+
+        explicit awaiter(spscq_oneshot &channel) noexcept : channel_(&channel) {}
+
+        spscq_oneshot *channel_;
+    };
+
+    /**
+     * @brief Suspends the awaiting coroutine until the value is sent.
+     *
+     * The coroutine is resumed on the sender's thread, inside send().
+     */
+    awaiter operator co_await() noexcept
+    {
+        return awaiter(*this);
+    }
+#endif
+
+    /**
+     * @brief Discards a sent but unreceived value and returns the channel to empty.
+     *
+     * @note Must only be called when neither side is using the channel
+     */
+    void reset() noexcept
+    {
+        if (state_.load(std::memory_order_acquire) == ready)
+        {
+            value().~T();
+        }
+
+        state_.store(empty, std::memory_order_relaxed);
+    }
+
+private:
+    /** State word values */
+    static constexpr uint32_t empty = 0;
+    static constexpr uint32_t ready = 1;
+    static constexpr uint32_t sleeping = 2;
+    static constexpr uint32_t awaiting = 3;
+
+    T &value() noexcept
+    {
+        return *std::launder(reinterpret_cast<T *>(&storage_));
+    }
+
+    /**
+     * @brief Moves the value out and returns the channel to empty.
+     */
+    T take()
+    {
+        T result = std::move(value());
+        value().~T();
+        state_.store(empty, std::memory_order_relaxed);
+        return result;
+    }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "The state word must be usable as a futex.");
+
+    std::atomic<uint32_t> state_{empty};
+
+    /** Address of the awaiting coroutine, written before the state moves to awaiting */
+    void *continuation_ = nullptr;
+
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage_;
+};
+
+/**
+ * @brief Fixed-size pool of one-shot channels for allocation-free request/response.
+ *
+ * The requesting thread acquires a channel, passes it along with the request, receives
+ * the response on it and releases it back to the pool. All channels are allocated once,
+ * contiguously, when the pool is created.
+ *
+ * @tparam T The type of the values carried by the channels
+ *
+ * @note acquire() and release() must be called from the same thread
+ */
+template <typename T>
+class spscq_oneshot_pool
+{
+public:
+    /**
+     * @param size Number of channels in the pool
+     * @throws std::invalid_argument if size is 0
+     */
+    explicit spscq_oneshot_pool(size_t size)
+        : channels_(new spscq_oneshot<T>[size])
+    {
+        if (size == 0)
+        {
+            throw std::invalid_argument("Pool size must be greater than 0");
+        }
+
+        free_.reserve(size);
+        for (size_t i = size; i > 0; --i)
+        {
+            free_.push_back(&channels_[i - 1]);
+        }
+    }
+
+    /**
+     * @brief Takes an empty channel out of the pool.
+     *
+     * @return spscq_oneshot<T>* The channel, or nullptr if the pool is exhausted
+     */
+    spscq_oneshot<T> *acquire() noexcept
+    {
+        if (free_.empty())
+        {
+            return nullptr;
+        }
+
+        spscq_oneshot<T> *channel = free_.back();
+        free_.pop_back();
+        return channel;
+    }
+
+    /**
+     * @brief Returns a channel to the pool.
+     *
+     * @note The value must have been received, or neither side may still use the channel
+     */
+    void release(spscq_oneshot<T> *channel) noexcept
+    {
+        channel->reset();
+        free_.push_back(channel);
+    }
+
+    /** Returns the number of channels currently available */
+    size_t available() const noexcept { return free_.size(); }
+
+private:
+    std::unique_ptr<spscq_oneshot<T>[]> channels_;
+    std::vector<spscq_oneshot<T> *> free_;
+};
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "spscq_config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief An SPSC queue whose slots hold live objects for the queue's whole lifetime.
+ *
+ * spscq constructs an element on every push and destroys it on every pop, so any heap
+ * buffer owned by the element (a std::vector's storage, a std::string's characters) is
+ * allocated and freed once per message. spscq_persistent constructs every slot once,
+ * up front, and never destroys them until the queue itself is destroyed:
+ *
+ * - the producer gets a reference to the next free slot and assigns or refills it,
+ *   reusing whatever capacity the object already owns;
+ * - the consumer swaps the slot's contents out, handing its own previous object back
+ *   to the ring for the producer to refill.
+ *
+ * In steady state no allocation happens at all: the same buffers circulate between
+ * the producer, the ring and the consumer.
+ *
+ * @tparam T The type of the slot objects, default-constructible and swappable
+ * @tparam Allocator The allocator type used for memory management, defaults to std::allocator<T>
+ *
+ * @note This queue is designed for single-producer single-consumer scenarios only.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class spscq_persistent
+{
+public:
+    /**
+     * @brief Returns the next free slot for the producer to fill.
+     *
+     * The slot holds whatever the consumer last swapped into it. It becomes visible
+     * to the consumer only when commit() is called.
+     *
+     * @return T* The free slot, or nullptr if the queue is full
+     *
+     * @note Must only be called from the producer thread
+     */
+    T *try_acquire() noexcept
+    {
+        const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+        const size_t nextWriteIdx = increment(writeIdx);
+
+        if (nextWriteIdx == readIdxCached_)
+        {
+            readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+            if (nextWriteIdx == readIdxCached_)
+            {
+                return nullptr;
+            }
+        }
+
+        return &data_[writeIdx];
+    }
+
+    /**
+     * @brief Publishes the slot returned by the last successful try_acquire().
+     *
+     * @note Must only be called from the producer thread
+     */
+    void commit() noexcept
+    {
+        writeIdx_.store(increment(writeIdx_.load(std::memory_order_relaxed)), std::memory_order_release);
+    }
+
+    /**
+     * @brief Attempts to refill the next free slot in place and publish it.
+     *
+     * @param fill Callable invoked as fill(T &slot)
+     * @return true if a slot was filled and published
+     * @return false if the queue was full
+     *
+     * @note Must only be called from the producer thread
+     */
+    template <typename F>
+    bool try_fill(F &&fill)
+    {
+        T *slot = try_acquire();
+        if (slot == nullptr)
+        {
+            return false;
+        }
+
+        std::forward<F>(fill)(*slot);
+        commit();
+        return true;
+    }
+
+    /**
+     * @brief Attempts to assign a value to the next free slot and publish it.
+     *
+     * @param value Value assigned to the slot
+     * @return true if the value was added
+     * @return false if the queue was full
+     *
+     * @note Must only be called from the producer thread
+     */
+    template <typename P>
+    bool try_push(P &&value)
+    {
+        return try_fill([&value](T &slot) { slot = std::forward<P>(value); });
+    }
+
+    /**
+     * @brief Returns the front slot without releasing it.
+     *
+     * @return T* The front slot, or nullptr if the queue is empty
+     *
+     * @note Must only be called from the consumer thread
+     */
+    T *front() noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        if (readIdx == writeIdxCached_)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+            if (readIdx == writeIdxCached_)
+            {
+                return nullptr;
+            }
+        }
+
+        return &data_[readIdx];
+    }
+
+    /**
+     * @brief Releases the front slot back to the producer, keeping its object alive.
+     *
+     * @note Must only be called from the consumer thread after front() returned a non-null pointer
+     */
+    void pop() noexcept
+    {
+        readIdx_.store(increment(readIdx_.load(std::memory_order_relaxed)), std::memory_order_release);
+    }
+
+    /**
+     * @brief Attempts to swap the front slot's contents into value.
+     *
+     * The previous contents of value go back into the ring, where the producer will
+     * reuse them.
+     *
+     * @param value Object exchanged with the front slot
+     * @return true if an element was removed
+     * @return false if the queue was empty
+     *
+     * @note Must only be called from the consumer thread
+     */
+    bool try_pop(T &value) noexcept(std::is_nothrow_swappable_v<T>)
+    {
+        T *slot = front();
+        if (slot == nullptr)
+        {
+            return false;
+        }
+
+        using std::swap;
+        swap(value, *slot);
+        pop();
+        return true;
+    }
+
+    /**
+     * @brief Calls f(slot) on every slot, e.g. to reserve capacity before use.
+     *
+     * @note Not thread-safe: must be called before the queue is shared
+     */
+    template <typename F>
+    void prepare(F &&f)
+    {
+        for (size_t i = 0; i < size_; ++i)
+        {
+            f(data_[i]);
+        }
+    }
+
+    /**
+     * @brief Returns the current number of published elements.
+     *
+     * @note The result is a snapshot and may be stale by the time the caller uses it
+     */
+    size_t size() const noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_acquire);
+        const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+
+        return writeIdx - readIdx + (writeIdx < readIdx ? size_ : 0);
+    }
+
+    /**
+     * @brief Checks if the queue is empty.
+     *
+     * @note The result may be stale by the time the caller uses it
+     */
+    bool empty() const noexcept
+    {
+        return readIdx_.load(std::memory_order_relaxed) == writeIdx_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Constructs the queue and default-constructs every slot.
+     *
+     * @param size The number of slots (actual capacity will be size-1)
+     * @param alloc The allocator instance to use for memory allocation
+     * @throws std::invalid_argument if size is 0
+     * @throws std::bad_alloc if memory allocation fails
+     */
+    explicit spscq_persistent(size_t size, const Allocator &alloc = Allocator()) : allocator_(alloc), size_(size)
+    {
+        if (size == 0)
+        {
+            throw std::invalid_argument("Queue size must be greater than 0");
+        }
+
+        data_ = allocator_.allocate(size);
+
+        size_t i = 0;
+        try
+        {
+            for (; i < size; ++i)
+            {
+                new (&data_[i]) T();
+            }
+        }
+        catch (...)
+        {
+            while (i > 0)
+            {
+                data_[--i].~T();
+            }
+            allocator_.deallocate(data_, size);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Destroys every slot and deallocates the storage.
+     *
+     * @note This operation is not thread-safe and should only be called
+     *       when no other threads are accessing the queue
+     */
+    ~spscq_persistent() noexcept
+    {
+        for (size_t i = 0; i < size_; ++i)
+        {
+            data_[i].~T();
+        }
+
+        allocator_.deallocate(data_, size_);
+    }
+
+    spscq_persistent(const spscq_persistent &) = delete;
+    spscq_persistent &operator=(const spscq_persistent &) = delete;
+
+private:
+    size_t increment(size_t index) const noexcept
+    {
+        size_t nextIdx = index + 1;
+        return (nextIdx == size_) ? 0 : nextIdx;
+    }
+
+    /** The allocator instance used for memory management */
+    Allocator allocator_;
+
+    /** Pointer to the slots, all alive from construction to destruction */
+    T *data_;
+
+    /** Number of slots (actual capacity is size_ - 1) */
+    size_t size_;
+
+    /**
+     * Indices, each on its own cache line as in spscq.
+     *
+     * readIdx_: Index where the consumer reads from
+     * readIdxCached_: Producer's cache of the consumer's read index
+     * writeIdx_: Index where the producer writes to
+     * writeIdxCached_: Consumer's cache of the producer's write index
+     */
+    alignas(spscq_config::interferenceSize) std::atomic<size_t> readIdx_{0};
+    alignas(spscq_config::interferenceSize) size_t readIdxCached_ = 0;
+    alignas(spscq_config::interferenceSize) std::atomic<size_t> writeIdx_{0};
+    alignas(spscq_config::interferenceSize) size_t writeIdxCached_ = 0;
+};
@@ -0,0 +1,612 @@
+#pragma once
+
+#include "spscq.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * Thread and memory placement for queue endpoints.
+ *
+ * cpu_topology reads the CPU, cache and NUMA layout from sysfs; choose_cpu_pair picks a
+ * producer and a consumer CPU with the requested relation; launch_pair starts the two
+ * endpoint functions already pinned; make_queue_for allocates a queue on the NUMA node of
+ * its consumer. Everything is best effort: placement that the system refuses (a single
+ * CPU, no NUMA, restricted affinity) falls back to running unpinned or unbound.
+ */
+
+/** Placement of one CPU as read from sysfs. */
+struct cpu_info
+{
+    int cpu;
+
+    /** Physical package (socket) id. */
+    int package;
+
+    /** Core id within the package; SMT siblings share it. */
+    int core;
+
+    /** NUMA node. */
+    int node;
+
+    /** Lowest CPU sharing this CPU's L2 cache, identifying the L2 domain. */
+    int l2;
+
+    /** Lowest CPU sharing this CPU's last-level cache, identifying the LLC domain. */
+    int llc;
+};
+
+/** Relation requested between the producer's and the consumer's CPUs. */
+enum class cpu_relation
+{
+    /** SMT siblings: distinct CPUs of one physical core, sharing its L1 cache. */
+    same_core,
+
+    /** Distinct CPUs sharing an L2 cache (SMT siblings on most x86 parts). */
+    same_l2,
+
+    /** Distinct physical cores sharing the last-level cache. */
+    same_llc,
+
+    /** CPUs in different packages, or on different NUMA nodes. */
+    cross_socket,
+};
+
+/**
+ * @brief CPU, cache and NUMA layout of the machine.
+ */
+class cpu_topology
+{
+public:
+    /**
+     * @brief Reads the topology of the CPUs this process may run on.
+     */
+    static cpu_topology detect()
+    {
+        cpu_topology topology = from_sysfs("/sys/devices/system");
+
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+        {
+            auto &cpus = topology.cpus_;
+            cpus.erase(std::remove_if(cpus.begin(), cpus.end(),
+                                      [&allowed](const cpu_info &info) { return !CPU_ISSET(info.cpu, &allowed); }),
+                       cpus.end());
+        }
+
+        if (topology.cpus_.empty())
+        {
+            topology.cpus_.push_back(cpu_info{0, 0, 0, 0, 0, 0});
+        }
+
+        return topology;
+    }
+
+    /**
+     * @brief Reads the topology of all online CPUs below a sysfs root.
+     *
+     * @param root Directory laid out like /sys/devices/system, with cpu/online,
+     *        cpu/cpuN/topology, cpu/cpuN/cache and cpu/cpuN/nodeM entries
+     */
+    static cpu_topology from_sysfs(const std::string &root)
+    {
+        cpu_topology topology;
+
+        for (int cpu : parse_cpu_list(read_line(root + "/cpu/online")))
+        {
+            const std::string dir = root + "/cpu/cpu" + std::to_string(cpu);
+
+            cpu_info info{cpu, read_int(dir + "/topology/physical_package_id", 0),
+                          read_int(dir + "/topology/core_id", cpu), node_of(dir), cpu, -1};
+
+            int llcLevel = 0;
+            for (int index = 0;; ++index)
+            {
+                const std::string cache = dir + "/cache/index" + std::to_string(index);
+                const int level = read_int(cache + "/level", -1);
+                if (level < 0)
+                {
+                    break;
+                }
+                if (read_line(cache + "/type") == "Instruction")
+                {
+                    continue;
+                }
+
+                const std::vector<int> shared = parse_cpu_list(read_line(cache + "/shared_cpu_list"));
+                const int domain = shared.empty() ? cpu : *std::min_element(shared.begin(), shared.end());
+
+                if (level == 2)
+                {
+                    info.l2 = domain;
+                }
+                if (level > llcLevel)
+                {
+                    llcLevel = level;
+                    info.llc = domain;
+                }
+            }
+
+            if (info.llc < 0)
+            {
+                // Without cache information, assume the package shares one cache
+                info.llc = -1 - info.package;
+            }
+
+            topology.cpus_.push_back(info);
+        }
+
+        return topology;
+    }
+
+    const std::vector<cpu_info> &cpus() const noexcept { return cpus_; }
+
+    /** Returns the placement of a CPU, or nullptr if it is not part of the topology. */
+    const cpu_info *find(int cpu) const noexcept
+    {
+        for (const cpu_info &info : cpus_)
+        {
+            if (info.cpu == cpu)
+            {
+                return &info;
+            }
+        }
+        return nullptr;
+    }
+
+    /** Returns the NUMA node of a CPU, 0 if unknown. */
+    int node_of_cpu(int cpu) const noexcept
+    {
+        const cpu_info *info = find(cpu);
+        return info != nullptr ? info->node : 0;
+    }
+
+    /** Parses a sysfs CPU list such as "0-3,8,10-11". */
+    static std::vector<int> parse_cpu_list(const std::string &list)
+    {
+        std::vector<int> cpus;
+        size_t pos = 0;
+
+        while (pos < list.size())
+        {
+            size_t end = list.find(',', pos);
+            if (end == std::string::npos)
+            {
+                end = list.size();
+            }
+
+            const std::string range = list.substr(pos, end - pos);
+            const size_t dash = range.find('-');
+            if (!range.empty())
+            {
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+
+            pos = end + 1;
+        }
+
+        return cpus;
+    }
+
+private:
+    static std::string read_line(const std::string &path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    static int read_int(const std::string &path, int fallback)
+    {
+        const std::string line = read_line(path);
+        return line.empty() ? fallback : std::stoi(line);
+    }
+
+    /** Returns M for the cpuN/nodeM link of a CPU directory, 0 if there is none. */
+    static int node_of(const std::string &cpuDir)
+    {
+        int node = 0;
+
+        if (DIR *dir = opendir(cpuDir.c_str()))
+        {
+            while (const dirent *entry = readdir(dir))
+            {
+                const std::string name = entry->d_name;
+                if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                    name.find_first_not_of("0123456789", 4) == std::string::npos)
+                {
+                    node = std::stoi(name.substr(4));
+                    break;
+                }
+            }
+            closedir(dir);
+        }
+
+        return node;
+    }
+
+    std::vector<cpu_info> cpus_;
+};
+
+/** A producer and a consumer CPU. */
+struct cpu_pair
+{
+    int producer;
+    int consumer;
+
+    /** False if the requested relation was not available and a fallback was chosen. */
+    bool exact;
+};
+
+/**
+ * @brief Picks a producer and a consumer CPU with the requested relation.
+ *
+ * Falls back to the closest available relation (cross-socket to same LLC to same L2 to
+ * same core, then any two CPUs), and to a single CPU on single-CPU systems, with
+ * `exact` cleared.
+ */
+inline cpu_pair choose_cpu_pair(cpu_relation relation, const cpu_topology &topology = cpu_topology::detect())
+{
+    const std::vector<cpu_info> &cpus = topology.cpus();
+
+    auto pair_of = [&cpus](auto &&match, cpu_pair &out) -> bool
+    {
+        for (const cpu_info &a : cpus)
+        {
+            for (const cpu_info &b : cpus)
+            {
+                if (a.cpu != b.cpu && match(a, b))
+                {
+                    out = cpu_pair{a.cpu, b.cpu, true};
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    auto sameCore = [](const cpu_info &a, const cpu_info &b) { return a.package == b.package && a.core == b.core; };
+    auto sameL2 = [](const cpu_info &a, const cpu_info &b) { return a.l2 == b.l2; };
+    auto sameLlc = [](const cpu_info &a, const cpu_info &b) { return a.llc == b.llc && a.l2 != b.l2; };
+    auto crossSocket = [](const cpu_info &a, const cpu_info &b) { return a.package != b.package || a.node != b.node; };
+    auto any = [](const cpu_info &, const cpu_info &) { return true; };
+
+    cpu_pair pair{cpus.front().cpu, cpus.front().cpu, false};
+
+    switch (relation)
+    {
+    case cpu_relation::cross_socket:
+        if (pair_of(crossSocket, pair))
+        {
+            return pair;
+        }
+        [[fallthrough]];
+    case cpu_relation::same_llc:
+        if (pair_of(sameLlc, pair))
+        {
+            pair.exact = relation == cpu_relation::same_llc;
+            return pair;
+        }
+        [[fallthrough]];
+    case cpu_relation::same_l2:
+        if (pair_of(sameL2, pair))
+        {
+            pair.exact = relation == cpu_relation::same_l2;
+            return pair;
+        }
+        [[fallthrough]];
+    case cpu_relation::same_core:
+        if (pair_of(sameCore, pair))
+        {
+            pair.exact = relation == cpu_relation::same_core;
+            return pair;
+        }
+        if (pair_of(any, pair))
+        {
+            pair.exact = false;
+        }
+        return pair;
+    }
+
+    return pair;
+}
+
+/**
+ * @brief Returns true if the two CPUs of the pair are SMT siblings of one physical core.
+ *
+ * Such a pair shares its L1 cache and is best served by spscq_smt.
+ */
+inline bool shares_core(const cpu_pair &cpus, const cpu_topology &topology = cpu_topology::detect())
+{
+    const cpu_info *producer = topology.find(cpus.producer);
+    const cpu_info *consumer = topology.find(cpus.consumer);
+
+    return producer != nullptr && consumer != nullptr && producer->cpu != consumer->cpu &&
+           producer->package == consumer->package && producer->core == consumer->core;
+}
+
+/**
+ * @brief Picks CPUs for a chain of `count` stages.
+ *
+ * Prefers distinct physical cores within one LLC, then other LLCs, then SMT siblings,
+ * and reuses CPUs when there are fewer than `count`.
+ */
+inline std::vector<int> choose_cpus(size_t count, const cpu_topology &topology = cpu_topology::detect())
+{
+    std::vector<cpu_info> cpus = topology.cpus();
+
+    // First CPU of each core before its siblings, grouped by LLC
+    std::stable_sort(cpus.begin(), cpus.end(), [](const cpu_info &a, const cpu_info &b) { return a.llc < b.llc; });
+
+    std::vector<std::pair<int, int>> seenCores;
+    std::vector<int> firsts, siblings;
+    for (const cpu_info &info : cpus)
+    {
+        const std::pair<int, int> core{info.package, info.core};
+        if (std::find(seenCores.begin(), seenCores.end(), core) == seenCores.end())
+        {
+            seenCores.push_back(core);
+            firsts.push_back(info.cpu);
+        }
+        else
+        {
+            siblings.push_back(info.cpu);
+        }
+    }
+    firsts.insert(firsts.end(), siblings.begin(), siblings.end());
+
+    std::vector<int> chosen;
+    for (size_t i = 0; i < count; ++i)
+    {
+        chosen.push_back(firsts[i % firsts.size()]);
+    }
+    return chosen;
+}
+
+/**
+ * @brief Pins the calling thread to a CPU.
+ *
+ * @return true if the affinity was set
+ */
+inline bool pin_current_thread(int cpu) noexcept
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/**
+ * @brief Starts a thread that pins itself to a CPU before running a function.
+ *
+ * Pinning from inside the thread means its stack and first allocations are already
+ * touched on the right NUMA node.
+ */
+template <typename F>
+std::thread launch_on(int cpu, F &&f)
+{
+    return std::thread(
+        [cpu, f = std::forward<F>(f)]() mutable
+        {
+            pin_current_thread(cpu);
+            f();
+        });
+}
+
+/**
+ * @brief A producer and a consumer thread started by launch_pair, joined on destruction.
+ */
+class placed_pair
+{
+public:
+    placed_pair(std::thread producer, std::thread consumer) noexcept
+        : producer_(std::move(producer)), consumer_(std::move(consumer))
+    {
+    }
+
+    placed_pair(placed_pair &&) noexcept = default;
+    placed_pair &operator=(placed_pair &&) = delete;
+
+    ~placed_pair() { join(); }
+
+    void join()
+    {
+        if (producer_.joinable())
+        {
+            producer_.join();
+        }
+        if (consumer_.joinable())
+        {
+            consumer_.join();
+        }
+    }
+
+private:
+    std::thread producer_;
+    std::thread consumer_;
+};
+
+/**
+ * @brief Runs a producer and a consumer function on the CPUs of a pair.
+ */
+template <typename P, typename C>
+placed_pair launch_pair(const cpu_pair &cpus, P &&producer, C &&consumer)
+{
+    std::thread p = launch_on(cpus.producer, std::forward<P>(producer));
+    return placed_pair(std::move(p), launch_on(cpus.consumer, std::forward<C>(consumer)));
+}
+
+namespace spscq_numa
+{
+    /**
+     * @brief Asks the kernel to place a page-aligned range on a NUMA node.
+     *
+     * Uses MPOL_PREFERRED, so allocation still succeeds when the node is full. Must be
+     * called before the range is first touched.
+     *
+     * @return true if the policy was applied
+     */
+    inline bool bind(void *addr, size_t bytes, int node) noexcept
+    {
+#ifdef SYS_mbind
+        constexpr int mpolPreferred = 1;
+        constexpr size_t maskBits = 1024;
+
+        if (node < 0 || static_cast<size_t>(node) >= maskBits)
+        {
+            return false;
+        }
+
+        unsigned long mask[maskBits / (8 * sizeof(unsigned long))] = {};
+        mask[static_cast<size_t>(node) / (8 * sizeof(unsigned long))] = 1ul << (static_cast<size_t>(node) % (8 * sizeof(unsigned long)));
+
+        return syscall(SYS_mbind, addr, bytes, mpolPreferred, mask, maskBits, 0) == 0;
+#else
+        (void)addr;
+        (void)bytes;
+        (void)node;
+        return false;
+#endif
+    }
+
+    /** Maps whole pages for `bytes` and binds them to a node. */
+    inline void *map(size_t bytes, int node)
+    {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t length = (bytes + page - 1) / page * page;
+
+        void *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        bind(base, length, node);
+        return base;
+    }
+
+    inline void unmap(void *base, size_t bytes) noexcept
+    {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        munmap(base, (bytes + page - 1) / page * page);
+    }
+}
+
+/**
+ * @brief Allocator placing each allocation on whole pages of a NUMA node.
+ *
+ * Meant for queue ring buffers, which are allocated once.
+ *
+ * @tparam T The type of elements to allocate
+ */
+template <typename T>
+class numa_allocator
+{
+public:
+    using value_type = T;
+
+    explicit numa_allocator(int node = 0) noexcept : node_(node) {}
+
+    template <typename U>
+    numa_allocator(const numa_allocator<U> &other) noexcept : node_(other.node_) {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(spscq_numa::map(n * sizeof(T), node_));
+    }
+
+    void deallocate(T *p, size_t n) noexcept
+    {
+        spscq_numa::unmap(p, n * sizeof(T));
+    }
+
+    int node() const noexcept { return node_; }
+
+    template <typename U>
+    bool operator==(const numa_allocator<U> &other) const noexcept { return node_ == other.node_; }
+
+    template <typename U>
+    bool operator!=(const numa_allocator<U> &other) const noexcept { return node_ != other.node_; }
+
+private:
+    template <typename U>
+    friend class numa_allocator;
+
+    int node_;
+};
+
+template <typename T>
+struct numa_delete
+{
+    void operator()(T *p) const noexcept
+    {
+        p->~T();
+        spscq_numa::unmap(p, sizeof(T));
+    }
+};
+
+template <typename T>
+using numa_ptr = std::unique_ptr<T, numa_delete<T>>;
+
+/**
+ * @brief Constructs an object on pages bound to a NUMA node.
+ *
+ * @param node NUMA node to place the object on
+ * @param args Arguments forwarded to the object's constructor
+ */
+template <typename T, typename... Args>
+numa_ptr<T> make_on_node(int node, Args &&...args)
+{
+    void *base = spscq_numa::map(sizeof(T), node);
+
+    try
+    {
+        return numa_ptr<T>(new (base) T(std::forward<Args>(args)...));
+    }
+    catch (...)
+    {
+        spscq_numa::unmap(base, sizeof(T));
+        throw;
+    }
+}
+
+template <typename T>
+using numa_spscq = spscq<T, numa_allocator<T>>;
+
+/**
+ * @brief Creates a queue whose indices and ring live on the consumer's NUMA node.
+ *
+ * The consumer's loads of new elements are then local, while the producer's stores to
+ * the remote ring can be buffered and do not stall it.
+ *
+ * @param cpus The CPUs the queue's endpoints will run on
+ * @param size Queue size, as for spscq
+ */
+template <typename T>
+numa_ptr<numa_spscq<T>> make_queue_for(const cpu_pair &cpus, size_t size, const cpu_topology &topology = cpu_topology::detect())
+{
+    const int node = topology.node_of_cpu(cpus.consumer);
+    return make_on_node<numa_spscq<T>>(node, size, numa_allocator<T>(node));
+}
@@ -0,0 +1,628 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#include "spscq_config.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Policies configuring spscq<T, Storage, Indexing, Publication, Wait, Stats, Layout>.
+ *
+ * Each policy is resolved at compile time: the queue calls static functions or
+ * members of empty types, and selects code paths with `if constexpr`, so a given
+ * combination carries no runtime branching on its configuration. The defaults
+ * (heap storage with std::allocator, wrap-compare indexing, eager publication,
+ * spin waiting, no statistics and padded indices) reproduce the behaviour of the unconfigured queue.
+ */
+
+/**
+ * @brief Storage policy owning a buffer obtained from an allocator.
+ *
+ * This is the default storage. Passing an allocator type instead of a storage policy
+ * as the second template argument of spscq selects heap_storage with that allocator.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam Allocator The allocator type used for the buffer
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class heap_storage
+{
+public:
+    static constexpr bool is_spscq_storage = true;
+
+    /**
+     * @param size Number of slots to allocate
+     * @param alloc The allocator instance to use for memory allocation
+     * @throws std::bad_alloc if memory allocation fails
+     */
+    explicit heap_storage(size_t size, const Allocator &alloc = Allocator())
+        : allocator_(alloc), data_(allocator_.allocate(size)), size_(size)
+    {
+    }
+
+    ~heap_storage() noexcept
+    {
+        allocator_.deallocate(data_, size_);
+    }
+
+    heap_storage(const heap_storage &) = delete;
+    heap_storage &operator=(const heap_storage &) = delete;
+
+    T *data() const noexcept { return data_; }
+
+private:
+    Allocator allocator_;
+    T *data_;
+    size_t size_;
+};
+
+/**
+ * @brief Storage policy embedding the buffer in the queue object itself.
+ *
+ * Avoids the allocation and the pointer indirection to a separate block, which suits
+ * small queues placed in static storage or inside another object.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam N Maximum number of slots
+ */
+template <typename T, size_t N>
+class inline_storage
+{
+public:
+    static_assert(N > 0, "Inline storage must hold at least one slot.");
+
+    static constexpr bool is_spscq_storage = true;
+
+    /**
+     * @param size Number of slots used, at most N
+     * @throws std::invalid_argument if size exceeds N
+     */
+    explicit inline_storage(size_t size)
+    {
+        if (size > N)
+        {
+            throw std::invalid_argument("Queue size exceeds the inline storage capacity");
+        }
+    }
+
+    inline_storage(const inline_storage &) = delete;
+    inline_storage &operator=(const inline_storage &) = delete;
+
+    T *data() noexcept { return reinterpret_cast<T *>(buffer_); }
+
+private:
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+};
+
+/**
+ * @brief Storage policy using a buffer owned by the caller.
+ *
+ * The buffer must be suitably aligned for T, hold at least `size` elements and
+ * outlive the queue. The queue constructs and destroys elements in it but never
+ * frees it.
+ *
+ * @tparam T The type of elements stored in the queue
+ */
+template <typename T>
+class external_storage
+{
+public:
+    static constexpr bool is_spscq_storage = true;
+
+    /**
+     * @param size Number of slots in the buffer
+     * @param buffer Uninitialized memory for at least size elements
+     * @throws std::invalid_argument if buffer is null
+     */
+    external_storage(size_t size, void *buffer) : data_(static_cast<T *>(buffer))
+    {
+        (void)size;
+
+        if (buffer == nullptr)
+        {
+            throw std::invalid_argument("External storage buffer must not be null");
+        }
+    }
+
+    external_storage(const external_storage &) = delete;
+    external_storage &operator=(const external_storage &) = delete;
+
+    T *data() const noexcept { return data_; }
+
+private:
+    T *data_;
+};
+
+namespace spscq_detail
+{
+    /**
+     * Atomic type used for the indices of spscq. Defining SPSCQ_ATOMIC to another class
+     * template before including spscq.hpp substitutes it, which is how the model checker
+     * in tests/ instruments the queue.
+     */
+#ifdef SPSCQ_ATOMIC
+    template <typename U>
+    using atomic = SPSCQ_ATOMIC<U>;
+#else
+    template <typename U>
+    using atomic = std::atomic<U>;
+#endif
+
+    /** Selects heap_storage<T, S> when S is an allocator rather than a storage policy. */
+    template <typename T, typename S, typename = void>
+    struct storage_for
+    {
+        using type = heap_storage<T, S>;
+    };
+
+    template <typename T, typename S>
+    struct storage_for<T, S, std::enable_if_t<S::is_spscq_storage>>
+    {
+        using type = S;
+    };
+
+    inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+}
+
+/**
+ * @brief Indexing policy wrapping indices with a compare against the size.
+ *
+ * Works with any size and is the default.
+ */
+struct wrap_indexing
+{
+    static void validate(size_t) {}
+
+    static size_t next(size_t index, size_t size) noexcept
+    {
+        const size_t nextIdx = index + 1;
+        return (nextIdx == size) ? 0 : nextIdx;
+    }
+
+    static size_t advance(size_t index, size_t count, size_t size) noexcept
+    {
+        const size_t nextIdx = index + count;
+        return (nextIdx >= size) ? nextIdx - size : nextIdx;
+    }
+};
+
+/**
+ * @brief Indexing policy wrapping indices with a mask, for power-of-two sizes.
+ *
+ * Replaces the compare-and-select of wrap_indexing with a single AND.
+ */
+struct mask_indexing
+{
+    /** @throws std::invalid_argument if size is not a power of two */
+    static void validate(size_t size)
+    {
+        if ((size & (size - 1)) != 0)
+        {
+            throw std::invalid_argument("Queue size must be a power of two with mask indexing");
+        }
+    }
+
+    static size_t next(size_t index, size_t size) noexcept
+    {
+        return (index + 1) & (size - 1);
+    }
+
+    static size_t advance(size_t index, size_t count, size_t size) noexcept
+    {
+        return (index + count) & (size - 1);
+    }
+};
+
+/**
+ * @brief Publication policy storing the write index after every push. The default.
+ */
+struct eager_publication
+{
+    static constexpr size_t batch = 1;
+};
+
+/**
+ * @brief Publication policy storing the write index once every N pushes.
+ *
+ * Pushed elements become visible to the consumer when N of them have accumulated,
+ * when the queue is found full, or when the producer calls flush().
+ *
+ * @tparam N Number of pushes between two publications
+ */
+template <size_t N>
+struct batched_publication
+{
+    static_assert(N > 0, "The publication batch must be at least 1.");
+
+    static constexpr size_t batch = N;
+};
+
+/**
+ * Wait policies are used by the blocking operations of the queue. Each side of the
+ * queue owns one instance: wait() is called after every failed attempt and reset()
+ * once the operation succeeds.
+ */
+
+/**
+ * @brief Wait policy spinning with a pause hint. The default.
+ */
+struct spin_wait
+{
+    void wait() noexcept { spscq_detail::cpu_relax(); }
+    void reset() noexcept {}
+};
+
+/**
+ * @brief Wait policy spinning for a number of attempts, then yielding the CPU.
+ *
+ * @tparam Spins Number of attempts spent spinning before yielding
+ */
+template <unsigned Spins = 1024>
+struct yield_wait
+{
+    void wait() noexcept
+    {
+        if (spins_ < Spins)
+        {
+            ++spins_;
+            spscq_detail::cpu_relax();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void reset() noexcept { spins_ = 0; }
+
+private:
+    unsigned spins_ = 0;
+};
+
+/**
+ * @brief Wait policy spinning, then yielding, then sleeping.
+ *
+ * @tparam Spins Number of attempts spent spinning
+ * @tparam Yields Number of attempts spent yielding after spinning
+ * @tparam SleepMicros Sleep duration in microseconds once both are exhausted
+ */
+template <unsigned Spins = 1024, unsigned Yields = 64, unsigned SleepMicros = 50>
+struct sleep_wait
+{
+    void wait() noexcept
+    {
+        if (attempts_ < Spins)
+        {
+            ++attempts_;
+            spscq_detail::cpu_relax();
+        }
+        else if (attempts_ < Spins + Yields)
+        {
+            ++attempts_;
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(SleepMicros));
+        }
+    }
+
+    void reset() noexcept { attempts_ = 0; }
+
+private:
+    unsigned attempts_ = 0;
+};
+
+/**
+ * @brief Wait policy learning how long to spin before sleeping.
+ *
+ * Every wait, from the first failed attempt to the reset() after success, is timed and
+ * recorded in a decaying histogram of power-of-two buckets. Every Window waits the
+ * policy picks the spin budget with the lowest expected cost, a nanosecond spun and a
+ * nanosecond of added latency counting alike: a wait shorter than the budget costs its
+ * length in spinning, a longer one costs the budget plus one sleep. This is competitive
+ * spinning (Karlin et al.) applied to the observed distribution; the initial budget,
+ * one sleep, is the 2-competitive choice for an unknown one.
+ *
+ * Sleeping hides when the element actually arrived, so such waits are only known to
+ * exceed the budget. They are spread over the durations above the budget in proportion
+ * to what probe waits saw there: the first wait of each window spins for up to four
+ * sleeps, which lets the budget grow again when sparse traffic turns dense.
+ *
+ * The chosen budget and the counters are stored with relaxed atomics, so they may be
+ * read from any thread through spscq's producer_wait() and consumer_wait().
+ *
+ * @tparam SleepMicros Sleep duration in microseconds once the budget is spent
+ * @tparam Window Number of waits between two choices of the budget
+ * @tparam Clock Clock timing the waits, defaults to std::chrono::steady_clock
+ */
+template <unsigned SleepMicros = 50, unsigned Window = 64, typename Clock = std::chrono::steady_clock>
+struct adaptive_wait
+{
+    static_assert(Window > 0, "The window must hold at least one wait.");
+
+    void wait() noexcept
+    {
+        const uint64_t now = now_ns();
+        if (!waiting_)
+        {
+            waiting_ = true;
+            slept_ = false;
+            start_ = now;
+            limit_ = probing_ ? probeNs : budget_ns();
+        }
+
+        if (now - start_ < limit_)
+        {
+            spscq_detail::cpu_relax();
+        }
+        else
+        {
+            slept_ = true;
+            sleeps_.store(sleeps_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::microseconds(SleepMicros));
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (!waiting_)
+        {
+            return;
+        }
+        waiting_ = false;
+
+        if (!slept_)
+        {
+            histogram_[bucket(now_ns() - start_)] += 1;
+        }
+        else if (probing_)
+        {
+            tail_ += 1;
+        }
+        else
+        {
+            censored_ += 1;
+        }
+        probing_ = false;
+
+        const uint64_t waits = waits_.load(std::memory_order_relaxed) + 1;
+        waits_.store(waits, std::memory_order_relaxed);
+        if (waits % Window == 0)
+        {
+            choose();
+        }
+    }
+
+    /** Current spin budget in nanoseconds. */
+    uint64_t budget_ns() const noexcept { return budgetNs_.load(std::memory_order_relaxed); }
+
+    /** Number of waits recorded. */
+    uint64_t waits() const noexcept { return waits_.load(std::memory_order_relaxed); }
+
+    /** Number of sleeps taken. */
+    uint64_t sleeps() const noexcept { return sleeps_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint64_t sleepNs = SleepMicros * uint64_t(1000);
+    static constexpr uint64_t probeNs = 4 * sleepNs;
+
+    /** Bucket b holds waits in [2^b, 2^(b+1)) ns; the last one also holds longer waits. */
+    static constexpr size_t buckets = 40;
+
+    static uint64_t now_ns() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         Clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    static size_t bucket(uint64_t ns) noexcept
+    {
+        const size_t b = ns == 0 ? 0 : 63 - static_cast<size_t>(__builtin_clzll(ns));
+        return b < buckets ? b : buckets - 1;
+    }
+
+    void choose() noexcept
+    {
+        const uint64_t budget = budget_ns();
+
+        // Waits cut short by a sleep follow the distribution seen above the budget
+        double above = tail_;
+        for (size_t b = 0; b < buckets; ++b)
+        {
+            above += (uint64_t(1) << b) >= budget ? histogram_[b] : 0;
+        }
+        if (above == 0)
+        {
+            tail_ += censored_;
+        }
+        else
+        {
+            const double scale = 1 + censored_ / above;
+            for (size_t b = 0; b < buckets; ++b)
+            {
+                histogram_[b] *= (uint64_t(1) << b) >= budget ? scale : 1;
+            }
+            tail_ *= scale;
+        }
+        censored_ = 0;
+
+        // Candidates are 0 and the bucket bounds up to the probe length
+        double total = tail_;
+        for (size_t b = 0; b < buckets; ++b)
+        {
+            total += histogram_[b];
+        }
+
+        double bestCost = total * static_cast<double>(sleepNs);
+        uint64_t bestBudget = 0;
+        double spun = 0;
+        double covered = 0;
+
+        for (size_t b = 0; b < buckets && (uint64_t(2) << b) <= probeNs; ++b)
+        {
+            const double candidate = static_cast<double>(uint64_t(2) << b);
+            spun += histogram_[b] * 1.5 * static_cast<double>(uint64_t(1) << b);
+            covered += histogram_[b];
+
+            const double cost = spun + (total - covered) * (candidate + static_cast<double>(sleepNs));
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestBudget = uint64_t(2) << b;
+            }
+        }
+
+        budgetNs_.store(bestBudget, std::memory_order_relaxed);
+
+        // Older windows weigh half as much as each newer one
+        for (double &weight : histogram_)
+        {
+            weight /= 2;
+        }
+        tail_ /= 2;
+        probing_ = true;
+    }
+
+    bool waiting_ = false;
+    bool slept_ = false;
+    bool probing_ = false;
+    uint64_t start_ = 0;
+    uint64_t limit_ = 0;
+
+    double histogram_[buckets] = {};
+    double tail_ = 0;
+    double censored_ = 0;
+
+    std::atomic<uint64_t> budgetNs_{sleepNs};
+    std::atomic<uint64_t> waits_{0};
+    std::atomic<uint64_t> sleeps_{0};
+};
+
+/**
+ * @brief Wait policy for a producer and a consumer running on SMT siblings of one core.
+ *
+ * A waiter spinning on its sibling competes with it for the core's issue slots and load
+ * buffers, slowing down the very thread it waits for. Each attempt therefore issues a
+ * burst of pause hints, handing the core to the sibling for longer between polls. Across
+ * cores a single pause per attempt is better, since polling is an L1 hit until the peer
+ * invalidates the line.
+ *
+ * @tparam Pauses Number of pause hints per failed attempt
+ */
+template <unsigned Pauses = 8>
+struct smt_wait
+{
+    void wait() noexcept
+    {
+        for (unsigned i = 0; i < Pauses; ++i)
+        {
+            spscq_detail::cpu_relax();
+        }
+    }
+
+    void reset() noexcept {}
+};
+
+/**
+ * Stats policies receive events from the queue. Each side of the queue owns one
+ * instance, written only by that side's thread.
+ */
+
+/**
+ * @brief Stats policy ignoring all events. The default.
+ */
+struct no_stats
+{
+    void on_push(size_t) noexcept {}
+    void on_pop(size_t) noexcept {}
+    void on_full() noexcept {}
+    void on_empty() noexcept {}
+    void on_wait() noexcept {}
+};
+
+/**
+ * @brief Stats policy counting events.
+ *
+ * Counters are written by a single thread with relaxed stores, so they may be read
+ * from any thread while the queue is in use.
+ */
+class counting_stats
+{
+public:
+    void on_push(size_t count) noexcept { bump(pushes_, count); }
+    void on_pop(size_t count) noexcept { bump(pops_, count); }
+    void on_full() noexcept { bump(full_, 1); }
+    void on_empty() noexcept { bump(empty_, 1); }
+    void on_wait() noexcept { bump(waits_, 1); }
+
+    /** Number of elements pushed. */
+    uint64_t pushes() const noexcept { return pushes_.load(std::memory_order_relaxed); }
+
+    /** Number of elements popped. */
+    uint64_t pops() const noexcept { return pops_.load(std::memory_order_relaxed); }
+
+    /** Number of push attempts that found the queue full. */
+    uint64_t full() const noexcept { return full_.load(std::memory_order_relaxed); }
+
+    /** Number of pop attempts that found the queue empty. */
+    uint64_t empty() const noexcept { return empty_.load(std::memory_order_relaxed); }
+
+    /** Number of wait steps taken by blocking operations. */
+    uint64_t waits() const noexcept { return waits_.load(std::memory_order_relaxed); }
+
+private:
+    static void bump(std::atomic<uint64_t> &counter, size_t count) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> pushes_{0};
+    std::atomic<uint64_t> pops_{0};
+    std::atomic<uint64_t> full_{0};
+    std::atomic<uint64_t> empty_{0};
+    std::atomic<uint64_t> waits_{0};
+};
+
+/**
+ * Layout policies set the alignment of the queue's index groups: the four shared
+ * indices, the consumer-private state and the producer-private state.
+ */
+
+/**
+ * @brief Layout keeping every index group SPSCQ_INTERFERENCE_SIZE bytes apart. The default.
+ */
+struct padded_layout
+{
+    static constexpr size_t alignment = spscq_config::interferenceSize;
+};
+
+/**
+ * @brief Layout packing all index state into consecutive words.
+ *
+ * For a producer and a consumer on SMT siblings of one core, which share the L1 cache:
+ * there is no coherence traffic between them to avoid, and padding only spreads the
+ * indices over five interference blocks of L1 instead of one line. Across cores this
+ * layout false-shares on every operation.
+ */
+struct dense_layout
+{
+    static constexpr size_t alignment = alignof(size_t);
+};
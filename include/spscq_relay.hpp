@@ -0,0 +1,174 @@
+#pragma once
+
+#include "spscq_placement.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Picks the CPU for the relay thread of a cross-socket pair.
+ *
+ * Prefers a CPU on the consumer's NUMA node on a different core from both endpoints,
+ * then an SMT sibling of the consumer, then the consumer's own CPU. A sibling of the
+ * producer is never chosen, as the relay would compete with it for the core.
+ */
+inline int choose_relay_cpu(const cpu_pair &cpus, const cpu_topology &topology = cpu_topology::detect())
+{
+    const cpu_info *consumer = topology.find(cpus.consumer);
+    if (consumer == nullptr)
+    {
+        return cpus.consumer;
+    }
+    const cpu_info *producer = topology.find(cpus.producer);
+
+    int sibling = cpus.consumer;
+    for (const cpu_info &info : topology.cpus())
+    {
+        if (info.node != consumer->node || info.cpu == cpus.consumer || info.cpu == cpus.producer)
+        {
+            continue;
+        }
+
+        const bool consumerCore = info.package == consumer->package && info.core == consumer->core;
+        const bool producerCore = producer != nullptr && info.package == producer->package && info.core == producer->core;
+        if (!consumerCore && !producerCore)
+        {
+            return info.cpu;
+        }
+        if (consumerCore)
+        {
+            sibling = info.cpu;
+        }
+    }
+
+    return sibling;
+}
+
+/**
+ * @brief Carries a queue across sockets in bulk through a relay thread.
+ *
+ * A single spscq whose producer and consumer are on different sockets moves an index
+ * line across the interconnect for nearly every operation. spscq_relay splits it into
+ * an inbound queue on the producer's node and an outbound queue on the consumer's node.
+ * A relay thread on the consumer's socket pops up to maxBatch elements at a time from
+ * the inbound queue and pushes them into the outbound queue with try_push_n. Both
+ * endpoints then only exchange indices with threads on their own socket, and the
+ * interconnect carries batches of elements with one index transfer each.
+ *
+ * The extra hop adds latency for an isolated message and pays off under sustained
+ * traffic; relay_bench shows where the crossover lies on a given machine.
+ *
+ * @tparam T The type of elements, default-constructible and copy-assignable
+ * @tparam Wait Wait policy of the relay thread while the inbound queue is empty or the
+ *         outbound queue is full, defaults to spin_wait
+ */
+template <typename T, typename Wait = spin_wait>
+class spscq_relay
+{
+public:
+    using queue_type = numa_spscq<T>;
+
+    /**
+     * @brief Creates both queues on their endpoints' nodes and starts the relay thread.
+     *
+     * @param cpus The CPUs the producer and the consumer will run on
+     * @param size Size of each of the two queues, as for spscq
+     * @param maxBatch Maximum number of elements moved per transfer
+     * @param topology Machine layout used to find the nodes and the relay CPU
+     */
+    spscq_relay(const cpu_pair &cpus, size_t size, size_t maxBatch = 256, const cpu_topology &topology = cpu_topology::detect())
+        : inbound_(make_queue_on(topology.node_of_cpu(cpus.producer), size)),
+          outbound_(make_queue_on(topology.node_of_cpu(cpus.consumer), size)),
+          maxBatch_(maxBatch == 0 ? 1 : maxBatch),
+          relayCpu_(choose_relay_cpu(cpus, topology))
+    {
+        thread_ = launch_on(relayCpu_, [this]() { run(); });
+    }
+
+    /**
+     * @brief Forwards whatever is left in the inbound queue, then stops the thread.
+     *
+     * @note Blocks until the outbound queue has room for the remaining elements, so the
+     *       consumer must keep popping until the relay is destroyed
+     */
+    ~spscq_relay() noexcept
+    {
+        stop_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+
+    spscq_relay(const spscq_relay &) = delete;
+    spscq_relay &operator=(const spscq_relay &) = delete;
+
+    /** Returns the queue the producer pushes into, on the producer's node */
+    queue_type &producer_queue() noexcept { return *inbound_; }
+
+    /** Returns the queue the consumer pops from, on the consumer's node */
+    queue_type &consumer_queue() noexcept { return *outbound_; }
+
+    /** Returns the CPU the relay thread was pinned to */
+    int relay_cpu() const noexcept { return relayCpu_; }
+
+    /** Returns the number of elements relayed so far */
+    uint64_t messages() const noexcept { return messages_.load(std::memory_order_relaxed); }
+
+    /** Returns the number of batches relayed so far */
+    uint64_t batches() const noexcept { return batches_.load(std::memory_order_relaxed); }
+
+private:
+    static numa_ptr<queue_type> make_queue_on(int node, size_t size)
+    {
+        return make_on_node<queue_type>(node, size, numa_allocator<T>(node));
+    }
+
+    void run()
+    {
+        // Allocated after pinning, so first touch places the buffer on the relay's node
+        std::vector<T> batch(maxBatch_);
+        Wait wait;
+
+        for (;;)
+        {
+            const size_t n = inbound_->try_pop_n(batch.data(), maxBatch_);
+
+            if (n == 0)
+            {
+                if (stop_.load(std::memory_order_acquire) && inbound_->empty())
+                {
+                    return;
+                }
+                wait.wait();
+                continue;
+            }
+            wait.reset();
+
+            for (size_t pushed = 0; pushed < n;)
+            {
+                const size_t m = outbound_->try_push_n(batch.data() + pushed, n - pushed);
+                if (m == 0)
+                {
+                    wait.wait();
+                }
+                pushed += m;
+            }
+            wait.reset();
+
+            messages_.store(messages_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            batches_.store(batches_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    numa_ptr<queue_type> inbound_;
+    numa_ptr<queue_type> outbound_;
+    size_t maxBatch_;
+    int relayCpu_;
+
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::thread thread_;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "spscq.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief Storage policy placing the buffer in a named POSIX shared memory object.
+ *
+ * The object is created exclusively with shm_open, sized to the buffer and mapped
+ * shared; it is unmapped and unlinked when the queue is destroyed. Other processes can
+ * map the same name to observe the ring, for example to record or inspect traffic.
+ * An existing object of the same name, possibly another queue's live buffer, is left
+ * untouched and makes construction fail.
+ *
+ * @tparam T The type of elements stored in the queue
+ *
+ * Defined apart from spscq_policies.hpp so that the core queue does not depend on POSIX
+ * headers.
+ *
+ * @note Only the element buffer lives in the shared object: the indices stay in the
+ *       queue, which remains a single-process queue
+ */
+template <typename T>
+class shm_storage
+{
+public:
+    static constexpr bool is_spscq_storage = true;
+
+    /**
+     * @param size Number of slots in the buffer
+     * @param name Name of the shared memory object, starting with '/'
+     * @throws std::system_error with the errno of the failed call if the object already
+     *         exists or cannot be created, sized or mapped
+     */
+    shm_storage(size_t size, const char *name) : name_(name), bytes_(size * sizeof(T))
+    {
+        const int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "shm_open");
+        }
+
+        void *base = MAP_FAILED;
+        const char *failed = "ftruncate";
+        if (ftruncate(fd, static_cast<off_t>(bytes_)) == 0)
+        {
+            failed = "mmap";
+            base = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+
+        if (base == MAP_FAILED)
+        {
+            const int error = errno;
+            close(fd);
+            shm_unlink(name);
+            throw std::system_error(error, std::generic_category(), failed);
+        }
+
+        close(fd);
+
+        data_ = static_cast<T *>(base);
+    }
+
+    ~shm_storage() noexcept
+    {
+        munmap(data_, bytes_);
+        shm_unlink(name_.c_str());
+    }
+
+    shm_storage(const shm_storage &) = delete;
+    shm_storage &operator=(const shm_storage &) = delete;
+
+    T *data() const noexcept { return data_; }
+
+private:
+    std::string name_;
+    size_t bytes_;
+    T *data_;
+};
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "spscq_config.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief View of one column of an spscq_soa read window.
+ *
+ * A window may wrap around the end of the ring, so a column is made of up to two
+ * contiguous segments. Per-column kernels should loop over each segment directly;
+ * operator[] hides the split for convenience.
+ *
+ * @tparam T The type of the column's elements
+ */
+template <typename T>
+struct soa_column
+{
+    T *first;
+    size_t firstSize;
+    T *second;
+    size_t secondSize;
+
+    size_t size() const noexcept { return firstSize + secondSize; }
+
+    T &operator[](size_t i) const noexcept
+    {
+        return i < firstSize ? first[i] : second[i - firstSize];
+    }
+};
+
+/**
+ * @brief A structure-of-arrays SPSC queue for multi-field records.
+ *
+ * spscq<Record> stores records contiguously, so a consumer touching 2 of 8 fields still
+ * pulls every field through the cache. spscq_soa<Ts...> stores each field in its own
+ * ring array and shares a single pair of indices between all of them. The consumer
+ * gets per-column views of the available records, so vectorized per-column processing
+ * reads only the columns it needs.
+ *
+ * Indices are free-running and the capacity is a power of two, so every slot is usable.
+ *
+ * @tparam Ts The types of the record's fields, one ring array each
+ *
+ * @note This queue is designed for single-producer single-consumer scenarios only.
+ */
+template <typename... Ts>
+class spscq_soa
+{
+public:
+    static_assert(sizeof...(Ts) > 0, "A record must have at least one field.");
+
+    /**
+     * @brief Snapshot of the records available to the consumer.
+     */
+    class window
+    {
+    public:
+        /** Number of records in the window */
+        size_t size() const noexcept { return size_; }
+
+        bool empty() const noexcept { return size_ == 0; }
+
+        /**
+         * @brief Returns the view of field I for the records in the window.
+         */
+        template <size_t I>
+        soa_column<std::tuple_element_t<I, std::tuple<Ts...>>> column() const noexcept
+        {
+            auto *data = std::get<I>(queue_->columns_);
+            const size_t offset = readIdx_ & queue_->mask_;
+            const size_t firstSize = std::min(size_, queue_->capacity() - offset);
+
+            return {data + offset, firstSize, data, size_ - firstSize};
+        }
+
+    private:
+        friend class spscq_soa;
+
+        window(const spscq_soa *queue, size_t readIdx, size_t size) noexcept
+            : queue_(queue), readIdx_(readIdx), size_(size)
+        {
+        }
+
+        const spscq_soa *queue_;
+        size_t readIdx_;
+        size_t size_;
+    };
+
+    /**
+     * @brief Constructs a queue with one ring array per field.
+     *
+     * @param capacity Minimum number of records, rounded up to a power of two
+     * @throws std::invalid_argument if capacity is 0
+     * @throws std::bad_alloc if memory allocation fails
+     */
+    explicit spscq_soa(size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("Queue capacity must be greater than 0");
+        }
+
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size *= 2;
+        }
+        mask_ = size - 1;
+
+        allocate(std::index_sequence_for<Ts...>{});
+    }
+
+    /**
+     * @brief Destroys the remaining records and deallocates every column.
+     *
+     * @note This operation is not thread-safe and should only be called
+     *       when no other threads are accessing the queue
+     */
+    ~spscq_soa() noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+        destroy(readIdx, writeIdx_.load(std::memory_order_relaxed) - readIdx, std::index_sequence_for<Ts...>{});
+        deallocate(std::index_sequence_for<Ts...>{});
+    }
+
+    spscq_soa(const spscq_soa &) = delete;
+    spscq_soa &operator=(const spscq_soa &) = delete;
+
+    /**
+     * @brief Attempts to append a record, one value per field.
+     *
+     * @param fields Values forwarded to the constructors of the record's fields
+     * @return true if the record was added
+     * @return false if the queue was full
+     *
+     * @note Must only be called from the producer thread
+     * @note If constructing a field throws, the fields already constructed are destroyed
+     *       and the queue is left unchanged
+     */
+    template <typename... Us>
+    bool try_push(Us &&...fields)
+    {
+        static_assert(sizeof...(Us) == sizeof...(Ts), "A value must be provided for every field.");
+
+        const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+
+        if (writeIdx - readIdxCached_ > mask_)
+        {
+            readIdxCached_ = readIdx_.load(std::memory_order_acquire);
+            if (writeIdx - readIdxCached_ > mask_)
+            {
+                return false;
+            }
+        }
+
+        construct(writeIdx & mask_, std::index_sequence_for<Ts...>{}, std::forward<Us>(fields)...);
+        writeIdx_.store(writeIdx + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Returns a window over the records available to the consumer.
+     *
+     * @param maxCount Maximum number of records in the window
+     *
+     * @note Must only be called from the consumer thread
+     */
+    window read_window(size_t maxCount = static_cast<size_t>(-1)) noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        if (writeIdxCached_ - readIdx < maxCount)
+        {
+            writeIdxCached_ = writeIdx_.load(std::memory_order_acquire);
+        }
+
+        const size_t available = writeIdxCached_ - readIdx;
+        return window(this, readIdx, available < maxCount ? available : maxCount);
+    }
+
+    /**
+     * @brief Destroys the first n records of the last window and releases their slots.
+     *
+     * @note Must only be called from the consumer thread, with n not larger than the window
+     */
+    void commit_read(size_t n) noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+
+        destroy(readIdx, n, std::index_sequence_for<Ts...>{});
+        readIdx_.store(readIdx + n, std::memory_order_release);
+    }
+
+    /**
+     * @brief Attempts to move the front record out, one reference per field.
+     *
+     * @return true if a record was removed
+     * @return false if the queue was empty
+     *
+     * @note Must only be called from the consumer thread
+     */
+    bool try_pop(Ts &...fields)
+    {
+        window w = read_window(1);
+        if (w.empty())
+        {
+            return false;
+        }
+
+        const size_t slot = readIdx_.load(std::memory_order_relaxed) & mask_;
+        move_out(slot, std::index_sequence_for<Ts...>{}, fields...);
+        commit_read(1);
+
+        return true;
+    }
+
+    /** Returns the number of records the queue can hold */
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    /**
+     * @brief Returns the current number of records in the queue.
+     *
+     * @note The result is a snapshot and may be stale by the time the caller uses it
+     */
+    size_t size() const noexcept
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_acquire);
+        return writeIdx_.load(std::memory_order_relaxed) - readIdx;
+    }
+
+    /**
+     * @brief Checks if the queue is empty.
+     *
+     * @note The result may be stale by the time the caller uses it
+     */
+    bool empty() const noexcept { return size() == 0; }
+
+private:
+    template <size_t... Is>
+    void allocate(std::index_sequence<Is...>)
+    {
+        // Columns allocated before a failure are released by the catch below
+        try
+        {
+            ((std::get<Is>(columns_) = std::allocator<Ts>().allocate(capacity())), ...);
+        }
+        catch (...)
+        {
+            deallocate(std::index_sequence<Is...>{});
+            throw;
+        }
+    }
+
+    template <size_t... Is>
+    void deallocate(std::index_sequence<Is...>) noexcept
+    {
+        ((std::get<Is>(columns_) != nullptr ? std::allocator<Ts>().deallocate(std::get<Is>(columns_), capacity()) : void()), ...);
+    }
+
+    template <size_t... Is, typename... Us>
+    void construct(size_t slot, std::index_sequence<Is...>, Us &&...fields)
+    {
+        // Fields are constructed in order; the catch destroys those built before a throw
+        size_t constructed = 0;
+        try
+        {
+            ((new (&std::get<Is>(columns_)[slot]) Ts(std::forward<Us>(fields)), ++constructed), ...);
+        }
+        catch (...)
+        {
+            ((Is < constructed ? std::get<Is>(columns_)[slot].~Ts() : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... Is>
+    void move_out(size_t slot, std::index_sequence<Is...>, Ts &...fields)
+    {
+        ((fields = std::move(std::get<Is>(columns_)[slot])), ...);
+    }
+
+    template <size_t... Is>
+    void destroy(size_t readIdx, size_t n, std::index_sequence<Is...>) noexcept
+    {
+        if constexpr (!(std::is_trivially_destructible_v<Ts> && ...))
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                const size_t slot = (readIdx + i) & mask_;
+                (std::get<Is>(columns_)[slot].~Ts(), ...);
+            }
+        }
+    }
+
+    /** One ring array per field, all indexed by the same slot */
+    std::tuple<Ts *...> columns_{};
+    size_t mask_;
+
+    /**
+     * Free-running indices shared by all columns, each on its own cache line as in spscq.
+     *
+     * readIdx_: Position the consumer reads from
+     * readIdxCached_: Producer's cache of the consumer's read position
+     * writeIdx_: Position the producer writes to
+     * writeIdxCached_: Consumer's cache of the producer's write position
+     */
+    alignas(spscq_config::interferenceSize) std::atomic<size_t> readIdx_{0};
+    alignas(spscq_config::interferenceSize) size_t readIdxCached_ = 0;
+    alignas(spscq_config::interferenceSize) std::atomic<size_t> writeIdx_{0};
+    alignas(spscq_config::interferenceSize) size_t writeIdxCached_ = 0;
+};
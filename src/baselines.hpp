@@ -0,0 +1,284 @@
+#pragma once
+
+#include "spscq_config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+/**
+ * Reference SPSC queue designs used by compare_bench to justify spscq's design.
+ *
+ * All of them expose try_push / try_pop / flush over a fixed capacity of elements, so the
+ * benchmark drives them with exactly the same loop, and capacity() reports how many
+ * elements they actually hold. They are written for benchmarking, not for use elsewhere:
+ * ring capacities are rounded up to powers of two and T must be default-constructible
+ * and copy-assignable.
+ */
+namespace baseline
+{
+    /** Same padding as spscq, so the comparison measures the designs rather than the layout */
+    constexpr size_t cacheLine = spscq_config::interferenceSize;
+
+    inline size_t round_up_pow2(size_t n)
+    {
+        size_t size = 1;
+        while (size < n)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    /**
+     * @brief A bounded std::deque guarded by a std::mutex.
+     *
+     * Both sides contend on the lock for every element.
+     */
+    template <typename T>
+    class mutex_deque
+    {
+    public:
+        explicit mutex_deque(size_t capacity) : capacity_(capacity) {}
+
+        bool try_push(const T &value)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.size() == capacity_)
+            {
+                return false;
+            }
+            queue_.push_back(value);
+            return true;
+        }
+
+        bool try_pop(T &value)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty())
+            {
+                return false;
+            }
+            value = queue_.front();
+            queue_.pop_front();
+            return true;
+        }
+
+        void flush() noexcept {}
+
+        size_t capacity() const noexcept { return capacity_; }
+
+    private:
+        std::mutex mutex_;
+        std::deque<T> queue_;
+        size_t capacity_;
+    };
+
+    /**
+     * @brief Lamport's ring: shared head and tail indices, no cached copies.
+     *
+     * Every push loads the consumer's index and every pop loads the producer's index,
+     * so each operation pulls the other side's cache line. The indices run freely and
+     * are masked on access, so every slot of the ring is usable.
+     */
+    template <typename T>
+    class lamport
+    {
+    public:
+        explicit lamport(size_t capacity)
+            : mask_(round_up_pow2(capacity) - 1), data_(std::make_unique<T[]>(mask_ + 1))
+        {
+        }
+
+        bool try_push(const T &value)
+        {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) > mask_)
+            {
+                return false;
+            }
+            data_[tail & mask_] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(T &value)
+        {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            value = data_[head & mask_];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        void flush() noexcept {}
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+
+    private:
+        const size_t mask_;
+        std::unique_ptr<T[]> data_;
+        alignas(cacheLine) std::atomic<size_t> head_{0};
+        alignas(cacheLine) std::atomic<size_t> tail_{0};
+    };
+
+    /**
+     * @brief MCRingBuffer (Lee, Bu, Chandranmenon, 2010).
+     *
+     * Each side keeps a local copy of the other side's index, refreshed only when it
+     * appears full or empty, and publishes its own index once per batch of operations.
+     * A side publishes early when it finds the ring full or empty, so the two sides
+     * cannot wait on each other's unpublished progress. Indices run freely as in lamport.
+     */
+    template <typename T>
+    class mc_ring
+    {
+    public:
+        explicit mc_ring(size_t capacity, size_t batch = 64)
+            : mask_(round_up_pow2(capacity) - 1), batch_(batch), data_(std::make_unique<T[]>(mask_ + 1))
+        {
+        }
+
+        bool try_push(const T &value)
+        {
+            if (producer_.next - producer_.localRead > mask_)
+            {
+                producer_.localRead = read_.load(std::memory_order_acquire);
+                if (producer_.next - producer_.localRead > mask_)
+                {
+                    flush();
+                    return false;
+                }
+            }
+            data_[producer_.next & mask_] = value;
+            ++producer_.next;
+            if (++producer_.pending >= batch_)
+            {
+                flush();
+            }
+            return true;
+        }
+
+        bool try_pop(T &value)
+        {
+            if (consumer_.next == consumer_.localWrite)
+            {
+                consumer_.localWrite = write_.load(std::memory_order_acquire);
+                if (consumer_.next == consumer_.localWrite)
+                {
+                    release();
+                    return false;
+                }
+            }
+            value = data_[consumer_.next & mask_];
+            ++consumer_.next;
+            if (++consumer_.pending >= batch_)
+            {
+                release();
+            }
+            return true;
+        }
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+
+        /** Publishes the producer's pending elements. */
+        void flush() noexcept
+        {
+            if (producer_.pending != 0)
+            {
+                write_.store(producer_.next, std::memory_order_release);
+                producer_.pending = 0;
+            }
+        }
+
+    private:
+        struct side
+        {
+            size_t next = 0;
+            size_t localRead = 0;
+            size_t localWrite = 0;
+            size_t pending = 0;
+        };
+
+        void release() noexcept
+        {
+            if (consumer_.pending != 0)
+            {
+                read_.store(consumer_.next, std::memory_order_release);
+                consumer_.pending = 0;
+            }
+        }
+
+        const size_t mask_;
+        const size_t batch_;
+        std::unique_ptr<T[]> data_;
+        alignas(cacheLine) std::atomic<size_t> read_{0};
+        alignas(cacheLine) std::atomic<size_t> write_{0};
+        alignas(cacheLine) side consumer_;
+        alignas(cacheLine) side producer_;
+    };
+
+    /**
+     * @brief FastForward (Giacomoni, Moseley, Vachharajani, 2008).
+     *
+     * There are no shared indices: each slot carries its own full flag, so the producer
+     * and the consumer only meet on the slots themselves and never exchange index lines.
+     */
+    template <typename T>
+    class fast_forward
+    {
+    public:
+        explicit fast_forward(size_t capacity)
+            : mask_(round_up_pow2(capacity) - 1), slots_(std::make_unique<slot[]>(mask_ + 1))
+        {
+        }
+
+        bool try_push(const T &value)
+        {
+            slot &s = slots_[head_];
+            if (s.full.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            s.value = value;
+            s.full.store(true, std::memory_order_release);
+            head_ = (head_ + 1) & mask_;
+            return true;
+        }
+
+        bool try_pop(T &value)
+        {
+            slot &s = slots_[tail_];
+            if (!s.full.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            value = s.value;
+            s.full.store(false, std::memory_order_release);
+            tail_ = (tail_ + 1) & mask_;
+            return true;
+        }
+
+        void flush() noexcept {}
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+
+    private:
+        struct slot
+        {
+            std::atomic<bool> full{false};
+            T value{};
+        };
+
+        const size_t mask_;
+        std::unique_ptr<slot[]> slots_;
+        alignas(cacheLine) size_t head_ = 0;
+        alignas(cacheLine) size_t tail_ = 0;
+    };
+}
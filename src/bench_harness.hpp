@@ -0,0 +1,55 @@
+#pragma once
+
+#include "spscq_placement.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/**
+ * @brief Runs producer and consumer pinned to `cpus` and times them from a common start.
+ *
+ * Both threads are launched and pinned first, then released together once both are
+ * ready, so thread creation and pinning stay out of the measurement.
+ *
+ * @param cpus The CPUs of the producer and the consumer
+ * @param producer Callable run on cpus.producer
+ * @param consumer Callable run on cpus.consumer
+ * @return double Nanoseconds from the start signal until both threads have finished
+ */
+template <typename P, typename C>
+double timed_pair(const cpu_pair &cpus, P &&producer, C &&consumer)
+{
+    std::atomic<int> ready{0};
+    std::atomic<bool> start{false};
+
+    auto gate = [&ready, &start]()
+    {
+        ready.fetch_add(1);
+        while (!start.load(std::memory_order_acquire))
+            ;
+    };
+
+    placed_pair threads = launch_pair(
+        cpus,
+        [&]()
+        {
+            gate();
+            producer();
+        },
+        [&]()
+        {
+            gate();
+            consumer();
+        });
+
+    while (ready.load() != 2)
+        std::this_thread::yield();
+
+    const auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    threads.join();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+
+    return elapsed.count();
+}
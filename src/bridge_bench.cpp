@@ -0,0 +1,112 @@
+#include "spscq_bridge.hpp"
+#include "spscq_placement.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * Connects a pair of TCP sockets over the loopback interface.
+ */
+void connect_loopback(int &client, int &server)
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    socklen_t len = sizeof(addr);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(listener, 1) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &len) != 0)
+    {
+        throw std::runtime_error("Failed to listen on loopback");
+    }
+
+    client = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+    {
+        throw std::runtime_error("Failed to connect over loopback");
+    }
+
+    server = accept(listener, nullptr, nullptr);
+    close(listener);
+
+    int one = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+void benchmark(size_t maxBatch, uint64_t iterations, int consumerCpu)
+{
+    int client, server;
+    connect_loopback(client, server);
+
+    spscq<uint64_t> source(4096);
+    spscq<uint64_t> sink(4096);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    uint64_t frames;
+    {
+        spscq_bridge_receiver<uint64_t> receiver(sink, server);
+
+        std::thread consumer = launch_on(
+            consumerCpu, [&sink, iterations]()
+            {
+                uint64_t value;
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    while (!sink.try_pop(value))
+                        ;
+                }
+            });
+
+        {
+            spscq_bridge_sender<uint64_t> sender(source, client, maxBatch);
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                while (!source.try_push(i))
+                    ;
+            }
+            frames = sender.frames();
+        }
+
+        consumer.join();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << "batch=" << maxBatch
+              << " msgs/s=" << iterations / duration.count()
+              << " frames>=" << frames << "\n";
+
+    close(client);
+    close(server);
+}
+
+int main()
+{
+    const uint64_t iterations = 2'000'000;
+
+    // The producer runs on this thread; the consumer gets a core of its own
+    const std::vector<int> cpus = choose_cpus(2);
+    pin_current_thread(cpus[0]);
+
+    for (size_t maxBatch : {1, 4, 16, 64, 256, 1024, 4096})
+    {
+        benchmark(maxBatch, iterations, cpus[1]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "bench_harness.hpp"
+#include "spscq_bundle.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+/**
+ * Sends one element on each of five channels per round between two pinned threads, once
+ * through five separate spscq instances and once through an spscq_bundle of five
+ * channels, and prints the nanoseconds per round.
+ */
+
+constexpr size_t channelCount = 5;
+constexpr size_t capacity = 1024;
+
+double run_separate(const cpu_pair &cpus, uint64_t rounds)
+{
+    std::array<std::unique_ptr<spscq<uint64_t>>, channelCount> queues;
+    for (auto &queue : queues)
+    {
+        queue = std::make_unique<spscq<uint64_t>>(capacity + 1);
+    }
+
+    return timed_pair(
+               cpus,
+               [&]()
+               {
+                   for (uint64_t i = 0; i < rounds; ++i)
+                   {
+                       for (auto &queue : queues)
+                       {
+                           while (!queue->try_push(i))
+                               ;
+                       }
+                   }
+               },
+               [&]()
+               {
+                   uint64_t value;
+                   for (uint64_t i = 0; i < rounds; ++i)
+                   {
+                       for (auto &queue : queues)
+                       {
+                           while (!queue->try_pop(value))
+                               ;
+                       }
+                   }
+               }) /
+           static_cast<double>(rounds);
+}
+
+double run_bundle(const cpu_pair &cpus, uint64_t rounds)
+{
+    spscq_bundle<uint64_t, uint64_t, uint64_t, uint64_t, uint64_t> bundle(capacity);
+
+    return timed_pair(
+               cpus,
+               [&]()
+               {
+                   for (uint64_t i = 0; i < rounds; ++i)
+                   {
+                       while (!bundle.try_push<0>(i))
+                           ;
+                       while (!bundle.try_push<1>(i))
+                           ;
+                       while (!bundle.try_push<2>(i))
+                           ;
+                       while (!bundle.try_push<3>(i))
+                           ;
+                       while (!bundle.try_push<4>(i))
+                           ;
+                       bundle.publish();
+                   }
+               },
+               [&]()
+               {
+                   uint64_t value;
+                   for (uint64_t i = 0; i < rounds; ++i)
+                   {
+                       while (!bundle.try_pop<0>(value))
+                           ;
+                       while (!bundle.try_pop<1>(value))
+                           ;
+                       while (!bundle.try_pop<2>(value))
+                           ;
+                       while (!bundle.try_pop<3>(value))
+                           ;
+                       while (!bundle.try_pop<4>(value))
+                           ;
+                       bundle.release();
+                   }
+               }) /
+           static_cast<double>(rounds);
+}
+
+/**
+ * Usage: bundle_bench [rounds] [producer_cpu consumer_cpu]
+ */
+int main(int argc, char **argv)
+{
+    const uint64_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+    cpu_pair cpus = choose_cpu_pair(cpu_relation::same_llc);
+    if (argc > 3)
+    {
+        cpus = cpu_pair{std::atoi(argv[2]), std::atoi(argv[3]), true};
+    }
+
+    std::cout << "producer_cpu=" << cpus.producer << " consumer_cpu=" << cpus.consumer << " rounds=" << rounds
+              << " channels=" << channelCount << "\n";
+
+    for (int repeat = 0; repeat < 3; ++repeat)
+    {
+        std::cout << "separate ns/round=" << run_separate(cpus, rounds) << "\n";
+        std::cout << "bundle   ns/round=" << run_bundle(cpus, rounds) << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "bench_harness.hpp"
+#include "spscq_codec.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Moves a stream of uint64 values from a producer to a consumer through a queue placed
+ * on the consumer's NUMA node, once as raw words and once through the delta codec, and
+ * reports the bytes that crossed the ring and the throughput of each.
+ */
+
+using word_queue = numa_spscq<uint64_t>;
+
+constexpr size_t chunk = 128;
+
+struct result
+{
+    double nanoseconds;
+    uint64_t bytes;
+    uint64_t checksum;
+};
+
+result run_raw(const std::vector<uint64_t> &input, const cpu_pair &cpus, size_t queueSize)
+{
+    auto queue = make_queue_for<uint64_t>(cpus, queueSize);
+    result r{0, input.size() * sizeof(uint64_t), 0};
+
+    r.nanoseconds = timed_pair(
+        cpus,
+        [&]()
+        {
+            for (size_t pushed = 0; pushed < input.size();)
+            {
+                pushed += queue->try_push_n(input.data() + pushed, std::min(chunk, input.size() - pushed));
+            }
+        },
+        [&]()
+        {
+            uint64_t values[chunk];
+            for (size_t popped = 0; popped < input.size();)
+            {
+                const size_t n = queue->try_pop_n(values, chunk);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    r.checksum += values[i];
+                }
+                popped += n;
+            }
+        });
+
+    return r;
+}
+
+result run_codec(const std::vector<uint64_t> &input, const cpu_pair &cpus, size_t queueSize)
+{
+    auto queue = make_queue_for<uint64_t>(cpus, queueSize);
+    result r{0, 0, 0};
+
+    r.nanoseconds = timed_pair(
+        cpus,
+        [&]()
+        {
+            spscq_delta_writer<uint64_t, word_queue> writer(*queue);
+            writer.push_n(input.data(), input.size());
+            writer.flush();
+            r.bytes = writer.bytes();
+        },
+        [&]()
+        {
+            spscq_delta_reader<uint64_t, word_queue> reader(*queue);
+            for (size_t popped = 0; popped < input.size();)
+            {
+                for (uint64_t value : reader.try_read())
+                {
+                    r.checksum += value;
+                    ++popped;
+                }
+            }
+        });
+
+    return r;
+}
+
+void report(const char *workload, const char *mode, size_t count, const result &r)
+{
+    std::cout << workload << " " << mode << " bytes=" << r.bytes
+              << " bytes/value=" << static_cast<double>(r.bytes) / static_cast<double>(count)
+              << " ns/value=" << r.nanoseconds / static_cast<double>(count)
+              << " Mvalues/s=" << static_cast<double>(count) / r.nanoseconds * 1e3
+              << " ring_MB/s=" << static_cast<double>(r.bytes) / r.nanoseconds * 1e3 << "\n";
+}
+
+/**
+ * Usage: codec_bench [values] [producer_cpu consumer_cpu]
+ *
+ * Without CPUs, the producer and the consumer run on different sockets when the machine
+ * has several, which is where the codec is meant to pay off.
+ */
+int main(int argc, char **argv)
+{
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20'000'000;
+    const size_t queueSize = 4096;
+
+    cpu_pair cpus = choose_cpu_pair(cpu_relation::cross_socket);
+    if (argc > 3)
+    {
+        cpus = cpu_pair{std::atoi(argv[2]), std::atoi(argv[3]), true};
+    }
+
+    const cpu_topology topology = cpu_topology::detect();
+    std::cout << "producer_cpu=" << cpus.producer << " (node " << topology.node_of_cpu(cpus.producer)
+              << ") consumer_cpu=" << cpus.consumer << " (node " << topology.node_of_cpu(cpus.consumer)
+              << ") values=" << count << (cpus.exact ? "" : " (no second socket, same-socket pair)") << "\n";
+
+    std::mt19937_64 rng(1);
+    std::vector<uint64_t> timestamps(count), prices(count), random(count);
+    uint64_t t = 1'700'000'000'000'000'000ull;
+    int64_t price = 1'000'000;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint64_t r = rng();
+        t += r % 2000;
+        price += static_cast<int64_t>(r >> 32) % 21 - 10;
+        timestamps[i] = t;
+        prices[i] = static_cast<uint64_t>(price);
+        random[i] = rng();
+    }
+
+    const struct
+    {
+        const char *name;
+        const std::vector<uint64_t> &values;
+    } workloads[] = {{"timestamps", timestamps}, {"prices    ", prices}, {"random    ", random}};
+
+    for (const auto &workload : workloads)
+    {
+        const result raw = run_raw(workload.values, cpus, queueSize);
+        const result codec = run_codec(workload.values, cpus, queueSize);
+        if (raw.checksum != codec.checksum)
+        {
+            std::cerr << "checksum mismatch\n";
+            return 1;
+        }
+        report(workload.name, "raw  ", count, raw);
+        report(workload.name, "codec", count, codec);
+    }
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "spscq_placement.hpp"
+#include "spscq_color.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using queue_type = spscq<uint32_t, colored_allocator<uint32_t>>;
+
+/**
+ * Moves messages through `count` queues in lockstep: the producer pushes message i into
+ * queue i % count, so every queue touches the same slot index at about the same time.
+ * Without coloring, those slots and the queues' index blocks all map to the same cache
+ * sets; with coloring each queue gets its own offset.
+ */
+void benchmark(const char *name, size_t count, size_t colors, uint32_t iterations, const cpu_pair &cpus)
+{
+    std::vector<colored_ptr<queue_type>> queues;
+    for (size_t i = 0; i < count; ++i)
+    {
+        queues.push_back(make_colored<queue_type>(i, colors, 1024, colored_allocator<uint32_t>(i, colors)));
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    launch_pair(
+        cpus,
+        [&queues, count, iterations]()
+        {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                while (!queues[i % count]->try_push(i))
+                    ;
+            }
+        },
+        [&queues, count, iterations]()
+        {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                uint32_t value;
+                while (!queues[i % count]->try_pop(value))
+                    ;
+            }
+        })
+        .join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - start;
+    std::cout << name << " queues=" << count << " ns/msg=" << duration.count() / iterations << "\n";
+}
+
+int main()
+{
+    const uint32_t iterations = 50'000'000;
+    const cpu_pair cpus = choose_cpu_pair(cpu_relation::same_llc);
+
+    for (size_t count : {8, 16, 32, 64})
+    {
+        benchmark("page-aligned", count, 1, iterations, cpus);
+        benchmark("colored     ", count, cache_color::defaultColors, iterations, cpus);
+    }
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "spscq_placement.hpp"
+#include "spscq_compact.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+/**
+ * Round-robins messages over `count` queues of capacity 16: the producer pushes message i
+ * into queue i % count and the consumer pops it from the same queue. With few queues the
+ * traffic per queue is high and false sharing dominates; with many queues the index state
+ * no longer fits in cache and the footprint dominates.
+ */
+template <typename Queue>
+void benchmark(const char *name, size_t count, uint32_t iterations, const cpu_pair &cpus)
+{
+    std::allocator<Queue> alloc;
+    Queue *queues = alloc.allocate(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        new (&queues[i]) Queue(16);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    launch_pair(
+        cpus,
+        [queues, count, iterations]()
+        {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                while (!queues[i % count].try_push(i))
+                    ;
+            }
+        },
+        [queues, count, iterations]()
+        {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                uint32_t value;
+                while (!queues[i % count].try_pop(value))
+                    ;
+            }
+        })
+        .join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - start;
+
+    std::cout << name << " queues=" << count
+              << " index_bytes=" << sizeof(Queue) * count
+              << " ns/msg=" << duration.count() / iterations << "\n";
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        queues[i].~Queue();
+    }
+    alloc.deallocate(queues, count);
+}
+
+int main()
+{
+    const uint32_t iterations = 50'000'000;
+    const cpu_pair cpus = choose_cpu_pair(cpu_relation::same_llc);
+
+    for (size_t count : {1, 4, 64, 1024, 4096, 16384})
+    {
+        benchmark<spscq<uint32_t>>("spscq        ", count, iterations, cpus);
+        benchmark<spscq_compact<uint32_t>>("spscq_compact", count, iterations, cpus);
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "baselines.hpp"
+#include "spscq_placement.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * Passes `iterations` sequence numbers from a producer to a consumer, pinned to the CPUs of
+ * `cpus`, through a queue holding `capacity` elements, and returns the nanoseconds per
+ * message. The consumer checks the sequence so a broken design cannot win.
+ */
+template <typename Queue>
+double run(size_t capacity, uint32_t iterations, const cpu_pair &cpus)
+{
+    Queue queue(capacity);
+    std::atomic<int> ready{0};
+    std::atomic<bool> start{false};
+    bool ordered = true;
+
+    placed_pair threads = launch_pair(
+        cpus,
+        [&queue, &ready, &start, iterations]()
+        {
+            ready.fetch_add(1);
+            while (!start.load(std::memory_order_acquire))
+                ;
+
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                while (!queue.try_push(i))
+                    ;
+            }
+            queue.flush();
+        },
+        [&queue, &ready, &start, &ordered, iterations]()
+        {
+            ready.fetch_add(1);
+            while (!start.load(std::memory_order_acquire))
+                ;
+
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                uint32_t value;
+                while (!queue.try_pop(value))
+                    ;
+                ordered &= value == i;
+            }
+        });
+
+    // Start the clock once both threads are pinned and waiting
+    while (ready.load() != 2)
+        std::this_thread::yield();
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    start.store(true, std::memory_order_release);
+
+    threads.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - begin;
+
+    if (!ordered)
+    {
+        std::cerr << "sequence check failed\n";
+        std::exit(1);
+    }
+
+    return duration.count() / iterations;
+}
+
+/**
+ * Runs a design several times and prints the median and best ns/msg.
+ */
+template <typename Queue>
+void benchmark(const char *name, size_t capacity, uint32_t iterations, const cpu_pair &cpus)
+{
+    std::vector<double> samples;
+    for (int repeat = 0; repeat < 5; ++repeat)
+    {
+        samples.push_back(run<Queue>(capacity, iterations, cpus));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    std::cout << name << " capacity=" << Queue(capacity).capacity()
+              << " median_ns/msg=" << samples[samples.size() / 2]
+              << " best_ns/msg=" << samples.front()
+              << " Mmsg/s=" << 1e3 / samples[samples.size() / 2] << "\n";
+}
+
+/** spscq keeps one slot empty, so it is sized one above the capacity of the others. */
+template <typename T>
+struct spscq_sized : spscq<T>
+{
+    explicit spscq_sized(size_t capacity) : spscq<T>(capacity + 1) {}
+};
+
+/**
+ * Mask indexing needs a power-of-two size and keeps one slot empty, so it holds one
+ * element less than the others rather than nearly twice as many.
+ */
+template <typename T>
+struct spscq_masked_sized : spscq<T, std::allocator<T>, mask_indexing>
+{
+    explicit spscq_masked_sized(size_t capacity)
+        : spscq<T, std::allocator<T>, mask_indexing>(baseline::round_up_pow2(capacity))
+    {
+    }
+};
+
+/**
+ * Usage: compare_bench [iterations] [producer_cpu consumer_cpu]
+ *
+ * Without CPUs, the producer and the consumer run on two cores sharing the last-level cache.
+ */
+int main(int argc, char **argv)
+{
+    const uint32_t iterations = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 10'000'000;
+
+    cpu_pair cpus = choose_cpu_pair(cpu_relation::same_llc);
+    if (argc > 3)
+    {
+        cpus = cpu_pair{std::atoi(argv[2]), std::atoi(argv[3]), true};
+    }
+
+    std::cout << "producer_cpu=" << cpus.producer << " consumer_cpu=" << cpus.consumer
+              << " iterations=" << iterations << "\n";
+    if (cpus.producer == cpus.consumer)
+    {
+        std::cout << "warning: producer and consumer share a CPU, results measure scheduling, not the queues\n";
+    }
+
+    for (size_t capacity : {64, 1024, 16384})
+    {
+        benchmark<baseline::mutex_deque<uint32_t>>("mutex_deque ", capacity, iterations, cpus);
+        benchmark<baseline::lamport<uint32_t>>("lamport     ", capacity, iterations, cpus);
+        benchmark<baseline::mc_ring<uint32_t>>("mc_ring     ", capacity, iterations, cpus);
+        benchmark<baseline::fast_forward<uint32_t>>("fast_forward", capacity, iterations, cpus);
+        benchmark<spscq_sized<uint32_t>>("spscq       ", capacity, iterations, cpus);
+        benchmark<spscq_masked_sized<uint32_t>>("spscq_mask  ", capacity, iterations, cpus);
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "spscq_placement.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * Measures the effective false-sharing distance of the host: two threads pinned to
+ * different cores increment their own counter, the counters placed `distance` bytes
+ * apart, and the cost per increment is compared with counters a page apart. The
+ * smallest distance from which every larger one runs as fast as the reference is the
+ * distance spscq must keep between the two sides' state; it is 64 on machines with
+ * 64-byte lines and no pair prefetch, 128 on most recent x86 and on Apple cores.
+ */
+
+constexpr size_t pageSize = 4096;
+
+/**
+ * Runs both threads once and returns the nanoseconds per increment of the slower one.
+ */
+double run(std::atomic<uint64_t> *first, std::atomic<uint64_t> *second, uint64_t iterations, const cpu_pair &cpus)
+{
+    std::atomic<int> ready{0};
+    std::atomic<bool> start{false};
+    double elapsed[2] = {0, 0};
+
+    auto worker = [&ready, &start, iterations](std::atomic<uint64_t> *counter, double &ns)
+    {
+        ready.fetch_add(1);
+        while (!start.load(std::memory_order_acquire))
+            ;
+
+        const auto begin = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            counter->fetch_add(1, std::memory_order_relaxed);
+        }
+        const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - begin;
+        ns = duration.count() / static_cast<double>(iterations);
+    };
+
+    {
+        placed_pair threads = launch_pair(
+            cpus, [&]() { worker(first, elapsed[0]); }, [&]() { worker(second, elapsed[1]); });
+
+        while (ready.load() != 2)
+            std::this_thread::yield();
+        start.store(true, std::memory_order_release);
+    }
+
+    return std::max(elapsed[0], elapsed[1]);
+}
+
+/**
+ * Usage: interference_bench [iterations] [cpu_a cpu_b]
+ *
+ * Without CPUs, the threads run on two distinct cores sharing the last-level cache, which
+ * is where spscq's producer and consumer usually live. Siblings of one SMT core share
+ * their L1 and show no false sharing at any distance.
+ */
+int main(int argc, char **argv)
+{
+    const uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20'000'000;
+
+    cpu_pair cpus = choose_cpu_pair(cpu_relation::same_llc);
+    if (argc > 3)
+    {
+        cpus = cpu_pair{std::atoi(argv[2]), std::atoi(argv[3]), true};
+    }
+
+    std::cout << "cpu_a=" << cpus.producer << " cpu_b=" << cpus.consumer << " iterations=" << iterations
+              << " configured_interference_size=" << spscq_config::interferenceSize << "\n";
+    if (cpus.producer == cpus.consumer)
+    {
+        std::cout << "warning: both threads share a CPU, results measure scheduling, not the caches\n";
+    }
+
+    // Two pages, page aligned, so the block containing the first counter is known
+    auto *buffer = static_cast<unsigned char *>(std::aligned_alloc(pageSize, 2 * pageSize));
+    auto *first = new (buffer) std::atomic<uint64_t>(0);
+
+    const size_t distances[] = {8, 16, 32, 64, 128, 256, 512, pageSize};
+    std::vector<double> costs;
+
+    for (size_t distance : distances)
+    {
+        auto *second = new (buffer + distance) std::atomic<uint64_t>(0);
+
+        double best = run(first, second, iterations, cpus);
+        for (int repeat = 1; repeat < 3; ++repeat)
+        {
+            best = std::min(best, run(first, second, iterations, cpus));
+        }
+        costs.push_back(best);
+    }
+
+    const double reference = costs.back();
+    size_t effective = pageSize;
+    for (size_t i = costs.size(); i-- > 0;)
+    {
+        if (costs[i] > reference * 1.5)
+        {
+            break;
+        }
+        effective = distances[i];
+    }
+
+    for (size_t i = 0; i < costs.size(); ++i)
+    {
+        std::cout << "distance=" << distances[i] << " ns/increment=" << costs[i]
+                  << " slowdown=" << costs[i] / reference << "\n";
+    }
+
+    std::cout << "effective false-sharing distance: " << effective << " bytes\n";
+    if (effective > spscq_config::interferenceSize)
+    {
+        std::cout << "warning: larger than SPSCQ_INTERFERENCE_SIZE=" << spscq_config::interferenceSize
+                  << ", rebuild with -DSPSCQ_INTERFERENCE_SIZE=" << effective << "\n";
+    }
+
+    std::free(buffer);
+    return 0;
+}
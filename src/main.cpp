@@ -1,14 +1,16 @@
-#include "spscq.hpp"
+#include "spscq_placement.hpp"
 
 #include <chrono>
 #include <iostream>
 #include <thread>
 
-void benchmark(spscq<uint32_t> &rb, uint32_t iterations)
+template <typename Queue>
+void benchmark(Queue &rb, const cpu_pair &cpus, uint32_t iterations)
 {
     auto start = std::chrono::high_resolution_clock::now();
 
-    std::thread producer(
+    launch_pair(
+        cpus,
         [&rb, iterations]()
         {
             for (uint32_t i = 0; i < iterations; ++i)
@@ -16,9 +18,7 @@ void benchmark(spscq<uint32_t> &rb, uint32_t iterations)
                 while (!rb.try_push(i))
                     ;
             }
-        });
-
-    std::thread consumer(
+        },
         [&rb, iterations]()
         {
             for (uint32_t i = 0; i < iterations; ++i)
@@ -27,10 +27,8 @@ void benchmark(spscq<uint32_t> &rb, uint32_t iterations)
                 while (!rb.try_pop(value))
                     ;
             }
-        });
-
-    producer.join();
-    consumer.join();
+        })
+        .join();
 
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> duration = end - start;
@@ -39,7 +37,12 @@ void benchmark(spscq<uint32_t> &rb, uint32_t iterations)
 
 int main()
 {
-    spscq<uint32_t> q(1024);
-    benchmark(q, 1'000'000'000);
+    const cpu_topology topology = cpu_topology::detect();
+    const cpu_pair cpus = choose_cpu_pair(cpu_relation::same_llc, topology);
+    std::cout << "producer_cpu=" << cpus.producer << " consumer_cpu=" << cpus.consumer
+              << (cpus.exact ? "" : " (same LLC unavailable)") << "\n";
+
+    auto q = make_queue_for<uint32_t>(cpus, 1024, topology);
+    benchmark(*q, cpus, 1'000'000'000);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,288 @@
+#include "spscq_placement.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * A four-stage market data pipeline connected with spscq:
+ *
+ *   feed -> parse -> aggregate -> output
+ *
+ * The feed generates CSV trade messages of 60 to 120 bytes, parse turns them into binary
+ * trades, aggregate keeps per-symbol VWAP and volume, and output formats every update
+ * back to text. Each message carries the time it was pushed on its last hop, so every
+ * stage can attribute the time spent in the queue it came from.
+ */
+
+constexpr size_t symbolCount = 512;
+constexpr size_t hopCount = 3;
+
+uint64_t now_ns()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/** Timing carried with a message through the pipeline. */
+struct timing
+{
+    uint64_t createdNs;
+    uint64_t sentNs;
+    std::array<uint32_t, hopCount> hopNs;
+
+    void send() { sentNs = now_ns(); }
+
+    void receive(size_t hop)
+    {
+        const uint64_t now = now_ns();
+        hopNs[hop] = static_cast<uint32_t>(std::min<uint64_t>(now - sentNs, UINT32_MAX));
+    }
+};
+
+struct raw_message
+{
+    timing time;
+    uint32_t length;
+    char text[128];
+};
+
+struct trade
+{
+    timing time;
+    uint32_t symbol;
+    char side;
+    uint32_t quantity;
+    double price;
+};
+
+struct update
+{
+    timing time;
+    uint32_t symbol;
+    uint64_t volume;
+    double vwap;
+    double last;
+};
+
+/** Queues spin briefly then yield, so the pipeline stays usable when threads outnumber CPUs. */
+template <typename T>
+using hop_queue = spscq<T, std::allocator<T>, wrap_indexing, eager_publication, yield_wait<>>;
+
+/** Small xorshift generator, so the feed costs the same on every run. */
+struct xorshift
+{
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    uint64_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+void feed(hop_queue<raw_message> &out, uint64_t messages, uint64_t ratePerSec)
+{
+    xorshift rng;
+    const uint64_t start = now_ns();
+
+    for (uint64_t i = 0; i < messages; ++i)
+    {
+        if (ratePerSec != 0)
+        {
+            const uint64_t due = start + i * 1'000'000'000ull / ratePerSec;
+            while (now_ns() < due)
+                ;
+        }
+
+        raw_message msg;
+        const uint64_t r = rng.next();
+        const int length = std::snprintf(
+            msg.text, sizeof(msg.text), "T,%lu,SYM%04u,%c,%u,%u.%02u,XNAS,%lu,cond=@%c",
+            static_cast<unsigned long>(i), static_cast<unsigned>(r % symbolCount), (r >> 10) & 1 ? 'B' : 'S',
+            static_cast<unsigned>(1 + (r >> 11) % 5000), static_cast<unsigned>(10 + (r >> 24) % 990),
+            static_cast<unsigned>((r >> 34) % 100), static_cast<unsigned long>(r >> 40), 'A' + static_cast<char>((r >> 60) % 4));
+        msg.length = static_cast<uint32_t>(length);
+
+        msg.time.createdNs = now_ns();
+        msg.time.send();
+        out.push(msg);
+    }
+}
+
+/** Returns the field after `text` up to the next comma, advancing `text` past it. */
+const char *next_field(const char *&text)
+{
+    const char *field = text;
+    while (*text != ',' && *text != '\0')
+    {
+        ++text;
+    }
+    if (*text == ',')
+    {
+        ++text;
+    }
+    return field;
+}
+
+void parse(hop_queue<raw_message> &in, hop_queue<trade> &out, uint64_t messages)
+{
+    raw_message msg;
+    for (uint64_t i = 0; i < messages; ++i)
+    {
+        in.pop(msg);
+        msg.time.receive(0);
+
+        trade t;
+        t.time = msg.time;
+
+        const char *cursor = msg.text;
+        next_field(cursor);                                                   // type
+        next_field(cursor);                                                   // sequence
+        t.symbol = static_cast<uint32_t>(std::strtoul(next_field(cursor) + 3, nullptr, 10));
+        t.side = *next_field(cursor);
+        t.quantity = static_cast<uint32_t>(std::strtoul(next_field(cursor), nullptr, 10));
+        t.price = std::strtod(next_field(cursor), nullptr);
+
+        t.time.send();
+        out.push(t);
+    }
+}
+
+void aggregate(hop_queue<trade> &in, hop_queue<update> &out, uint64_t messages)
+{
+    struct book
+    {
+        uint64_t volume = 0;
+        double notional = 0;
+    };
+    std::vector<book> books(symbolCount);
+
+    trade t;
+    for (uint64_t i = 0; i < messages; ++i)
+    {
+        in.pop(t);
+        t.time.receive(1);
+
+        book &b = books[t.symbol % symbolCount];
+        b.volume += t.quantity;
+        b.notional += t.price * t.quantity;
+
+        update u;
+        u.time = t.time;
+        u.symbol = t.symbol;
+        u.volume = b.volume;
+        u.vwap = b.notional / static_cast<double>(b.volume);
+        u.last = t.price;
+
+        u.time.send();
+        out.push(u);
+    }
+}
+
+struct output_result
+{
+    std::vector<uint32_t> hops[hopCount];
+    std::vector<uint32_t> endToEnd;
+    uint64_t bytes = 0;
+};
+
+void output(hop_queue<update> &in, uint64_t messages, output_result &result)
+{
+    char line[128];
+
+    update u;
+    for (uint64_t i = 0; i < messages; ++i)
+    {
+        in.pop(u);
+        u.time.receive(2);
+
+        const int length = std::snprintf(line, sizeof(line), "SYM%04u vwap=%.4f last=%.2f vol=%lu\n", u.symbol, u.vwap,
+                                         u.last, static_cast<unsigned long>(u.volume));
+        result.bytes += static_cast<uint64_t>(length);
+
+        for (size_t hop = 0; hop < hopCount; ++hop)
+        {
+            result.hops[hop].push_back(u.time.hopNs[hop]);
+        }
+        result.endToEnd.push_back(static_cast<uint32_t>(std::min<uint64_t>(now_ns() - u.time.createdNs, UINT32_MAX)));
+    }
+}
+
+void print_percentiles(const char *name, std::vector<uint32_t> &samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    auto at = [&samples](double q) { return samples[static_cast<size_t>(q * static_cast<double>(samples.size() - 1))]; };
+
+    std::cout << name << " ns: p50=" << at(0.5) << " p90=" << at(0.9) << " p99=" << at(0.99)
+              << " p99.9=" << at(0.999) << " max=" << samples.back() << "\n";
+}
+
+/**
+ * Usage: pipeline_bench [messages] [rate_per_sec] [queue_size]
+ *
+ * A rate of 0 runs the feed flat out, which measures throughput; latency percentiles are
+ * only meaningful at a rate the pipeline can sustain.
+ */
+int main(int argc, char **argv)
+{
+    const uint64_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const uint64_t rate = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+    const size_t queueSize = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1024;
+
+    if (messages == 0)
+    {
+        return 0;
+    }
+
+    hop_queue<raw_message> raw(queueSize);
+    hop_queue<trade> trades(queueSize);
+    hop_queue<update> updates(queueSize);
+
+    output_result result;
+    for (auto &hop : result.hops)
+    {
+        hop.reserve(messages);
+    }
+    result.endToEnd.reserve(messages);
+
+    // Neighbouring stages on distinct cores of one LLC where the machine allows it
+    const std::vector<int> cpus = choose_cpus(4);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread feedThread = launch_on(cpus[0], [&] { feed(raw, messages, rate); });
+    std::thread parseThread = launch_on(cpus[1], [&] { parse(raw, trades, messages); });
+    std::thread aggregateThread = launch_on(cpus[2], [&] { aggregate(trades, updates, messages); });
+    std::thread outputThread = launch_on(cpus[3], [&] { output(updates, messages, result); });
+
+    feedThread.join();
+    parseThread.join();
+    aggregateThread.join();
+    outputThread.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "messages=" << messages << " rate=" << (rate == 0 ? "max" : std::to_string(rate))
+              << " queue_size=" << queueSize << " message_bytes=" << sizeof(raw_message) << "/" << sizeof(trade) << "/"
+              << sizeof(update) << " cpus=" << cpus[0] << "," << cpus[1] << "," << cpus[2] << "," << cpus[3] << "\n";
+    std::cout << "throughput: " << messages / elapsed.count() / 1e6 << " Mmsg/s, output "
+              << result.bytes / elapsed.count() / 1e6 << " MB/s\n";
+
+    print_percentiles("feed->parse      ", result.hops[0]);
+    print_percentiles("parse->aggregate ", result.hops[1]);
+    print_percentiles("aggregate->output", result.hops[2]);
+    print_percentiles("end-to-end       ", result.endToEnd);
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "bench_harness.hpp"
+#include "spscq_relay.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+/**
+ * Compares a direct cross-socket queue (placed on the consumer's node) with an
+ * spscq_relay for two message sizes. Streaming throughput shows what bulk transfers
+ * save under sustained traffic; ping-pong round trips show what the extra hop costs an
+ * isolated message. The relay is worth it when the first gain outweighs the second for
+ * the workload at hand.
+ */
+
+constexpr size_t queueSize = 4096;
+
+struct small_message
+{
+    uint64_t sequence = 0;
+};
+
+/** One cache line per message */
+struct line_message
+{
+    uint64_t sequence = 0;
+    unsigned char payload[56] = {};
+};
+
+/** Streams `iterations` messages from `in` to `out` and returns ns per message. */
+template <typename Msg, typename In, typename Out>
+double stream(const cpu_pair &cpus, In &in, Out &out, uint64_t iterations)
+{
+    return timed_pair(
+               cpus,
+               [&]()
+               {
+                   Msg msg;
+                   for (uint64_t i = 0; i < iterations; ++i)
+                   {
+                       msg.sequence = i;
+                       while (!in.try_push(msg))
+                           ;
+                   }
+               },
+               [&]()
+               {
+                   Msg msg;
+                   for (uint64_t i = 0; i < iterations; ++i)
+                   {
+                       while (!out.try_pop(msg))
+                           ;
+                   }
+               }) /
+           static_cast<double>(iterations);
+}
+
+/** Bounces one message at a time and returns ns per round trip. */
+template <typename Msg, typename PingIn, typename PingOut, typename PongIn, typename PongOut>
+double ping_pong(const cpu_pair &cpus, PingIn &pingIn, PingOut &pingOut, PongIn &pongIn, PongOut &pongOut, uint64_t iterations)
+{
+    return timed_pair(
+               cpus,
+               [&]()
+               {
+                   Msg msg;
+                   for (uint64_t i = 0; i < iterations; ++i)
+                   {
+                       msg.sequence = i;
+                       while (!pingIn.try_push(msg))
+                           ;
+                       while (!pongOut.try_pop(msg))
+                           ;
+                   }
+               },
+               [&]()
+               {
+                   Msg msg;
+                   for (uint64_t i = 0; i < iterations; ++i)
+                   {
+                       while (!pingOut.try_pop(msg))
+                           ;
+                       while (!pongIn.try_push(msg))
+                           ;
+                   }
+               }) /
+           static_cast<double>(iterations);
+}
+
+template <typename Msg>
+void benchmark(const cpu_pair &cpus, uint64_t iterations)
+{
+    const cpu_pair back{cpus.consumer, cpus.producer, cpus.exact};
+    const uint64_t rounds = std::max<uint64_t>(iterations / 100, 1);
+
+    {
+        auto queue = make_queue_for<Msg>(cpus, queueSize);
+        auto reply = make_queue_for<Msg>(back, queueSize);
+
+        const double streamNs = stream<Msg>(cpus, *queue, *queue, iterations);
+        const double roundTripNs = ping_pong<Msg>(cpus, *queue, *queue, *reply, *reply, rounds);
+
+        std::cout << "direct      bytes=" << sizeof(Msg) << " stream_ns/msg=" << streamNs
+                  << " round_trip_ns=" << roundTripNs << "\n";
+    }
+
+    for (size_t batch : {32, 256})
+    {
+        spscq_relay<Msg> relay(cpus, queueSize, batch);
+        spscq_relay<Msg> replyRelay(back, queueSize, batch);
+
+        const double streamNs = stream<Msg>(cpus, relay.producer_queue(), relay.consumer_queue(), iterations);
+        const double avgBatch = static_cast<double>(relay.messages()) / static_cast<double>(std::max<uint64_t>(relay.batches(), 1));
+        const double roundTripNs = ping_pong<Msg>(cpus, relay.producer_queue(), relay.consumer_queue(),
+                                                  replyRelay.producer_queue(), replyRelay.consumer_queue(), rounds);
+
+        std::cout << "relay_" << batch << (batch < 100 ? "    " : "   ") << "bytes=" << sizeof(Msg)
+                  << " stream_ns/msg=" << streamNs << " round_trip_ns=" << roundTripNs
+                  << " avg_batch=" << avgBatch << " relay_cpu=" << relay.relay_cpu() << "\n";
+    }
+}
+
+/**
+ * Usage: relay_bench [iterations] [producer_cpu consumer_cpu]
+ *
+ * Without CPUs, the producer and the consumer run on different sockets when the machine
+ * has several.
+ */
+int main(int argc, char **argv)
+{
+    const uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+    cpu_pair cpus = choose_cpu_pair(cpu_relation::cross_socket);
+    if (argc > 3)
+    {
+        cpus = cpu_pair{std::atoi(argv[2]), std::atoi(argv[3]), true};
+    }
+
+    const cpu_topology topology = cpu_topology::detect();
+    std::cout << "producer_cpu=" << cpus.producer << " (node " << topology.node_of_cpu(cpus.producer)
+              << ") consumer_cpu=" << cpus.consumer << " (node " << topology.node_of_cpu(cpus.consumer)
+              << ") iterations=" << iterations << (cpus.exact ? "" : " (no second socket, same-socket pair)") << "\n";
+
+    benchmark<small_message>(cpus, iterations);
+    benchmark<line_message>(cpus, iterations);
+
+    return 0;
+}
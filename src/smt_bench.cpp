@@ -0,0 +1,107 @@
+#include "bench_harness.hpp"
+#include "spscq.hpp"
+#include "spscq_placement.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+/**
+ * Compares spscq with spscq_smt with the producer and the consumer on SMT siblings of
+ * one core and on two separate cores of one LLC. Each configuration runs a streaming
+ * test (ns per message through one queue) and a ping-pong test (round-trip ns through
+ * a pair of queues), repeated three times, keeping the best run.
+ */
+
+template <typename Queue>
+double stream(const cpu_pair &cpus, uint64_t iterations)
+{
+    Queue queue(1024);
+
+    return timed_pair(
+               cpus,
+               [&]()
+               {
+                   for (uint64_t i = 0; i < iterations; ++i)
+                   {
+                       queue.push(i);
+                   }
+               },
+               [&]()
+               {
+                   uint64_t value;
+                   for (uint64_t i = 0; i < iterations; ++i)
+                   {
+                       queue.pop(value);
+                   }
+               }) /
+           static_cast<double>(iterations);
+}
+
+template <typename Queue>
+double ping_pong(const cpu_pair &cpus, uint64_t iterations)
+{
+    Queue ping(2);
+    Queue pong(2);
+
+    return timed_pair(
+               cpus,
+               [&]()
+               {
+                   uint64_t value;
+                   for (uint64_t i = 0; i < iterations; ++i)
+                   {
+                       ping.push(i);
+                       pong.pop(value);
+                   }
+               },
+               [&]()
+               {
+                   uint64_t value;
+                   for (uint64_t i = 0; i < iterations; ++i)
+                   {
+                       ping.pop(value);
+                       pong.push(value);
+                   }
+               }) /
+           static_cast<double>(iterations);
+}
+
+template <typename Queue>
+void benchmark(const char *name, const char *placement, const cpu_pair &cpus, uint64_t iterations)
+{
+    double streamNs = stream<Queue>(cpus, iterations);
+    double roundTripNs = ping_pong<Queue>(cpus, iterations / 10);
+    for (int repeat = 1; repeat < 3; ++repeat)
+    {
+        streamNs = std::min(streamNs, stream<Queue>(cpus, iterations));
+        roundTripNs = std::min(roundTripNs, ping_pong<Queue>(cpus, iterations / 10));
+    }
+
+    std::cout << name << " " << placement << " cpus=" << cpus.producer << "," << cpus.consumer
+              << (cpus.exact ? "" : " (fallback)") << " stream_ns/msg=" << streamNs
+              << " round_trip_ns=" << roundTripNs << "\n";
+}
+
+/**
+ * Usage: smt_bench [iterations]
+ */
+int main(int argc, char **argv)
+{
+    const uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+    const cpu_topology topology = cpu_topology::detect();
+    const cpu_pair siblings = choose_cpu_pair(cpu_relation::same_core, topology);
+    const cpu_pair cores = choose_cpu_pair(cpu_relation::same_llc, topology);
+
+    std::cout << "iterations=" << iterations << " smt_pair=" << (shares_core(siblings, topology) ? "yes" : "no") << "\n";
+
+    benchmark<spscq<uint64_t>>("spscq    ", "smt_siblings ", siblings, iterations);
+    benchmark<spscq_smt<uint64_t>>("spscq_smt", "smt_siblings ", siblings, iterations);
+    benchmark<spscq<uint64_t>>("spscq    ", "separate_core", cores, iterations);
+    benchmark<spscq_smt<uint64_t>>("spscq_smt", "separate_core", cores, iterations);
+
+    return 0;
+}
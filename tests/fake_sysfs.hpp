@@ -0,0 +1,60 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+/**
+ * @brief Fake sysfs trees for testing cpu_topology without depending on the host.
+ */
+
+inline void write_file(const std::filesystem::path &path, const std::string &content)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path) << content << "\n";
+}
+
+/**
+ * Builds a fake sysfs tree: `packages` packages of two cores with two SMT siblings
+ * each. Siblings share L1 and L2, a package shares L3 and is one NUMA node.
+ */
+inline std::filesystem::path make_sysfs(int packages)
+{
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / ("spscq_sysfs_" + std::to_string(getpid()) + "_" + std::to_string(packages));
+    std::filesystem::remove_all(root);
+
+    const int cpus = packages * 4;
+    write_file(root / "cpu/online", "0-" + std::to_string(cpus - 1));
+
+    for (int cpu = 0; cpu < cpus; ++cpu)
+    {
+        const std::filesystem::path dir = root / "cpu" / ("cpu" + std::to_string(cpu));
+        const int package = cpu / 4;
+        const int core = cpu / 2;
+        const std::string siblings = std::to_string(core * 2) + "-" + std::to_string(core * 2 + 1);
+        const std::string packageCpus = std::to_string(package * 4) + "-" + std::to_string(package * 4 + 3);
+
+        write_file(dir / "topology/physical_package_id", std::to_string(package));
+        write_file(dir / "topology/core_id", std::to_string(core % 2));
+        std::filesystem::create_directories(dir / ("node" + std::to_string(package)));
+
+        const struct
+        {
+            int level;
+            const char *type;
+            std::string shared;
+        } caches[] = {{1, "Data", siblings}, {1, "Instruction", siblings}, {2, "Unified", siblings}, {3, "Unified", packageCpus}};
+
+        for (int index = 0; index < 4; ++index)
+        {
+            const std::filesystem::path cache = dir / "cache" / ("index" + std::to_string(index));
+            write_file(cache / "level", std::to_string(caches[index].level));
+            write_file(cache / "type", caches[index].type);
+            write_file(cache / "shared_cpu_list", caches[index].shared);
+        }
+    }
+
+    return root;
+}
@@ -0,0 +1,725 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <ucontext.h>
+
+/**
+ * @brief A small stateless model checker for lock-free code under the C++ memory model.
+ *
+ * A scenario runs a few threads as cooperative fibers. Every operation on a
+ * model::atomic is a scheduling point, and every load may read any store that the
+ * memory model allows, not only the latest one. Each execution records the choices it
+ * made; the checker then re-runs the scenario from scratch, depth first, until every
+ * combination of thread interleavings (up to a preemption bound) and visible stores
+ * has been explored.
+ *
+ * Modelled semantics:
+ * - Each location has a modification order, in which stores are appended as they run.
+ * - A load reads any store not older than the latest store it happens-after, nor
+ *   older than what its thread has already read or written (coherence).
+ * - Release stores and acquire loads synchronize through vector clocks; relaxed
+ *   operations synchronize only through release and acquire fences. Read-modify-writes
+ *   read the latest store and continue its release sequence.
+ * - seq_cst operations are acquire/release and a seq_cst load reads at least the last
+ *   seq_cst store to its location. The single total order over all seq_cst operations
+ *   is not modelled, so Dekker-style code may be reported although it is correct.
+ * - Accesses to model::data objects are checked for data races against happens-before.
+ *
+ * Instrument a queue by defining SPSCQ_ATOMIC to model::atomic before including it,
+ * and store model::data elements in it.
+ */
+namespace model
+{
+    constexpr int maxThreads = 4;
+
+    using vector_clock = std::array<uint32_t, maxThreads>;
+
+    /** Limits of an exploration. */
+    struct options
+    {
+        /** Maximum number of preemptive context switches per execution, -1 for unbounded. */
+        int preemptionBound = 3;
+
+        /** Maximum number of executions before giving up. */
+        size_t maxExecutions = 2000000;
+
+        /** Maximum number of scheduling points in one execution, to catch livelocks. */
+        size_t maxSteps = 10000;
+    };
+
+    /** Outcome of an exploration. */
+    struct result
+    {
+        /** True if every explored execution passed its checks. */
+        bool ok = true;
+
+        /** True if the exploration was complete, false if maxExecutions cut it short. */
+        bool complete = true;
+
+        /** Number of executions explored. */
+        size_t executions = 0;
+
+        /** First failure found, with the trace of the failing execution. */
+        std::string report;
+    };
+
+    class explorer;
+
+    namespace detail
+    {
+        inline explorer *active = nullptr;
+
+        inline void join(vector_clock &into, const vector_clock &from) noexcept
+        {
+            for (int i = 0; i < maxThreads; ++i)
+            {
+                if (from[i] > into[i])
+                {
+                    into[i] = from[i];
+                }
+            }
+        }
+
+        inline bool is_acquire(std::memory_order order) noexcept
+        {
+            return order == std::memory_order_acquire || order == std::memory_order_consume ||
+                   order == std::memory_order_acq_rel || order == std::memory_order_seq_cst;
+        }
+
+        inline bool is_release(std::memory_order order) noexcept
+        {
+            return order == std::memory_order_release || order == std::memory_order_acq_rel ||
+                   order == std::memory_order_seq_cst;
+        }
+
+        inline const char *name(std::memory_order order) noexcept
+        {
+            switch (order)
+            {
+            case std::memory_order_relaxed:
+                return "relaxed";
+            case std::memory_order_consume:
+                return "consume";
+            case std::memory_order_acquire:
+                return "acquire";
+            case std::memory_order_release:
+                return "release";
+            case std::memory_order_acq_rel:
+                return "acq_rel";
+            default:
+                return "seq_cst";
+            }
+        }
+    }
+
+    /**
+     * @brief Runs scenarios and explores their executions.
+     *
+     * Thread 0 is the scenario's setup and teardown, which run outside of any
+     * interleaving; threads 1 to N run as fibers.
+     */
+    class explorer
+    {
+    public:
+        explicit explorer(const options &opts) : options_(opts), stacks_(maxThreads * stackSize) {}
+
+        explorer(const explorer &) = delete;
+        explorer &operator=(const explorer &) = delete;
+
+        /**
+         * @brief Explores all executions of a scenario.
+         *
+         * The scenario type is constructed for every execution on thread 0, then its
+         * `run(int thread)` member is called on `Scenario::threads` fibers numbered from
+         * 1, then `finish()` is called on thread 0 once they have all returned.
+         */
+        template <typename Scenario>
+        result explore()
+        {
+            static_assert(Scenario::threads >= 1 && Scenario::threads < maxThreads, "Too many scenario threads.");
+
+            result res;
+            detail::active = this;
+
+            do
+            {
+                begin();
+                {
+                    Scenario scenario;
+                    run_threads(Scenario::threads, [&scenario](int thread) { scenario.run(thread); });
+                    if (failure_.empty())
+                    {
+                        scenario.finish();
+                    }
+                }
+
+                ++res.executions;
+
+                if (!failure_.empty())
+                {
+                    res.ok = false;
+                    res.report = format_failure();
+                    break;
+                }
+
+                if (res.executions >= options_.maxExecutions)
+                {
+                    res.complete = false;
+                    break;
+                }
+            } while (backtrack());
+
+            detail::active = nullptr;
+            return res;
+        }
+
+        /** Registers a new location with its initial value, returning its id. */
+        size_t create(uint64_t value)
+        {
+            thread_state &self = threads_[current_];
+            locations_.push_back(location{});
+            locations_.back().stores.push_back(store_record{value, current_, self.clock[current_], self.clock, false});
+            return locations_.size() - 1;
+        }
+
+        uint64_t load(size_t id, std::memory_order order)
+        {
+            schedule();
+
+            thread_state &self = threads_[current_];
+            location &loc = locations_[id];
+
+            size_t lower = loc.seen[current_];
+            if (order == std::memory_order_seq_cst && loc.lastSeqCst > lower)
+            {
+                lower = loc.lastSeqCst;
+            }
+
+            for (size_t i = loc.stores.size(); i-- > lower;)
+            {
+                const store_record &s = loc.stores[i];
+                if (s.epoch <= self.clock[s.thread])
+                {
+                    lower = i;
+                    break;
+                }
+            }
+
+            // Choice 0 reads the latest store, later choices read older ones
+            const size_t last = loc.stores.size() - 1;
+            const size_t index = current_ == 0 ? last : last - choose(last - lower + 1);
+            const store_record &s = loc.stores[index];
+
+            loc.seen[current_] = index;
+            if (detail::is_acquire(order))
+            {
+                detail::join(self.clock, s.release);
+            }
+            else
+            {
+                detail::join(self.pendingAcquire, s.release);
+            }
+
+            log("load", id, order, s.value, index);
+            return s.value;
+        }
+
+        void store(size_t id, uint64_t value, std::memory_order order)
+        {
+            schedule();
+            append(id, value, order, nullptr);
+            log("store", id, order, value, locations_[id].stores.size() - 1);
+        }
+
+        /** Atomically replaces the latest value of a location with f(latest). */
+        uint64_t read_modify_write(size_t id, std::memory_order order, const std::function<uint64_t(uint64_t)> &f)
+        {
+            schedule();
+
+            thread_state &self = threads_[current_];
+            location &loc = locations_[id];
+            const store_record latest = loc.stores.back();
+
+            if (detail::is_acquire(order))
+            {
+                detail::join(self.clock, latest.release);
+            }
+            else
+            {
+                detail::join(self.pendingAcquire, latest.release);
+            }
+
+            append(id, f(latest.value), order, &latest.release);
+            log("rmw", id, order, latest.value, loc.stores.size() - 2);
+            return latest.value;
+        }
+
+        void fence(std::memory_order order)
+        {
+            thread_state &self = threads_[current_];
+
+            if (detail::is_acquire(order))
+            {
+                detail::join(self.clock, self.pendingAcquire);
+            }
+            if (detail::is_release(order))
+            {
+                self.fenceRelease = self.clock;
+                ++self.clock[current_];
+            }
+        }
+
+        /** Checks a plain read of the object at address against earlier writes. */
+        void read(const void *address)
+        {
+            shadow &sh = shadows_[address];
+            thread_state &self = threads_[current_];
+
+            if (sh.writer >= 0 && sh.written > self.clock[sh.writer])
+            {
+                race(address, "read", sh.writer);
+            }
+            sh.reads[current_] = self.clock[current_];
+        }
+
+        /** Checks a plain write of the object at address against earlier reads and writes. */
+        void write(const void *address)
+        {
+            shadow &sh = shadows_[address];
+            thread_state &self = threads_[current_];
+
+            if (sh.writer >= 0 && sh.written > self.clock[sh.writer])
+            {
+                race(address, "write", sh.writer);
+            }
+            for (int t = 0; t < maxThreads; ++t)
+            {
+                if (sh.reads[t] > self.clock[t])
+                {
+                    race(address, "write", t);
+                }
+            }
+
+            sh.writer = current_;
+            sh.written = self.clock[current_];
+            sh.reads.fill(0);
+        }
+
+        /** Records a failed scenario check. Only the first failure is kept. */
+        void fail(const std::string &message)
+        {
+            if (failure_.empty())
+            {
+                failure_ = "thread " + std::to_string(current_) + ": " + message;
+            }
+        }
+
+    private:
+        static constexpr size_t stackSize = 256 * 1024;
+
+        struct store_record
+        {
+            uint64_t value;
+            int thread;
+            uint32_t epoch;
+            vector_clock release;
+            bool seqCst;
+        };
+
+        struct location
+        {
+            std::vector<store_record> stores;
+            size_t lastSeqCst = 0;
+            std::array<size_t, maxThreads> seen{};
+        };
+
+        struct shadow
+        {
+            int writer = -1;
+            uint32_t written = 0;
+            std::array<uint32_t, maxThreads> reads{};
+        };
+
+        struct thread_state
+        {
+            vector_clock clock{};
+            vector_clock pendingAcquire{};
+            vector_clock fenceRelease{};
+            bool finished = false;
+        };
+
+        struct choice
+        {
+            size_t taken;
+            size_t count;
+        };
+
+        struct event
+        {
+            int thread;
+            const char *op;
+            size_t location;
+            std::memory_order order;
+            uint64_t value;
+            size_t index;
+        };
+
+        void begin()
+        {
+            locations_.clear();
+            shadows_.clear();
+            events_.clear();
+            failure_.clear();
+            position_ = 0;
+            steps_ = 0;
+            preemptions_ = 0;
+            current_ = 0;
+
+            for (thread_state &t : threads_)
+            {
+                t = thread_state{};
+            }
+            threads_[0].clock[0] = 1;
+        }
+
+        /** Moves to the next unexplored branch of the choice tree, or returns false when done. */
+        bool backtrack()
+        {
+            choices_.resize(position_);
+            while (!choices_.empty() && choices_.back().taken + 1 == choices_.back().count)
+            {
+                choices_.pop_back();
+            }
+
+            if (choices_.empty())
+            {
+                return false;
+            }
+
+            ++choices_.back().taken;
+            return true;
+        }
+
+        size_t choose(size_t count)
+        {
+            if (count <= 1)
+            {
+                return 0;
+            }
+
+            if (position_ == choices_.size())
+            {
+                choices_.push_back(choice{0, count});
+            }
+            return choices_[position_++].taken;
+        }
+
+        void append(size_t id, uint64_t value, std::memory_order order, const vector_clock *continued)
+        {
+            thread_state &self = threads_[current_];
+            location &loc = locations_[id];
+
+            vector_clock release = detail::is_release(order) ? self.clock : self.fenceRelease;
+            if (continued != nullptr)
+            {
+                detail::join(release, *continued);
+            }
+
+            const bool seqCst = order == std::memory_order_seq_cst;
+            loc.stores.push_back(store_record{value, current_, self.clock[current_], release, seqCst});
+            loc.seen[current_] = loc.stores.size() - 1;
+            if (seqCst)
+            {
+                loc.lastSeqCst = loc.stores.size() - 1;
+            }
+
+            ++self.clock[current_];
+        }
+
+        void race(const void *address, const char *access, int other)
+        {
+            std::ostringstream out;
+            out << "data race: " << access << " of " << address << " by thread " << current_
+                << " is unordered with an access by thread " << other;
+            fail(out.str());
+        }
+
+        void log(const char *op, size_t id, std::memory_order order, uint64_t value, size_t index)
+        {
+            if (current_ != 0)
+            {
+                events_.push_back(event{current_, op, id, order, value, index});
+            }
+        }
+
+        /** Scheduling point: lets the explorer switch to another fiber before an operation. */
+        void schedule()
+        {
+            if (current_ == 0)
+            {
+                return;
+            }
+
+            swapcontext(&contexts_[current_], &scheduler_);
+        }
+
+        void run_threads(int count, std::function<void(int)> body)
+        {
+            body_ = std::move(body);
+
+            // Spawning synchronizes the fibers with the setup
+            for (int t = 1; t <= count; ++t)
+            {
+                threads_[t].clock = threads_[0].clock;
+                threads_[t].clock[t] = 1;
+
+                getcontext(&contexts_[t]);
+                contexts_[t].uc_stack.ss_sp = &stacks_[(t - 1) * stackSize];
+                contexts_[t].uc_stack.ss_size = stackSize;
+                contexts_[t].uc_link = &scheduler_;
+                makecontext(&contexts_[t], &explorer::fiber_entry, 0);
+            }
+            ++threads_[0].clock[0];
+
+            int last = 0;
+            for (;;)
+            {
+                int runnable[maxThreads];
+                int n = 0;
+
+                // The thread that ran last comes first, so choice 0 never preempts
+                if (last != 0 && !threads_[last].finished)
+                {
+                    runnable[n++] = last;
+                }
+                for (int t = 1; t <= count; ++t)
+                {
+                    if (t != last && !threads_[t].finished)
+                    {
+                        runnable[n++] = t;
+                    }
+                }
+
+                if (n == 0)
+                {
+                    break;
+                }
+
+                if (++steps_ > options_.maxSteps)
+                {
+                    fail("step limit exceeded, possible livelock");
+                    break;
+                }
+
+                const bool preemptible = runnable[0] == last &&
+                                         (options_.preemptionBound < 0 || preemptions_ < options_.preemptionBound);
+                int next = runnable[0];
+                if (runnable[0] != last || preemptible)
+                {
+                    const size_t index = choose(static_cast<size_t>(n));
+                    next = runnable[index];
+                    if (index != 0 && runnable[0] == last)
+                    {
+                        ++preemptions_;
+                    }
+                }
+
+                current_ = next;
+                swapcontext(&scheduler_, &contexts_[next]);
+                current_ = 0;
+                last = next;
+            }
+
+            // Joining synchronizes the teardown with the fibers
+            for (int t = 1; t <= count; ++t)
+            {
+                detail::join(threads_[0].clock, threads_[t].clock);
+            }
+        }
+
+        static void fiber_entry()
+        {
+            explorer &self = *detail::active;
+            const int thread = self.current_;
+
+            self.body_(thread);
+            self.threads_[thread].finished = true;
+        }
+
+        std::string format_failure() const
+        {
+            std::ostringstream out;
+            out << failure_ << "\ntrace:\n";
+            for (const event &e : events_)
+            {
+                out << "  thread " << e.thread << ' ' << e.op << ' ' << detail::name(e.order) << " location "
+                    << e.location << " value " << e.value << " (store #" << e.index << ")\n";
+            }
+            return out.str();
+        }
+
+        options options_;
+        std::vector<char> stacks_;
+        ucontext_t scheduler_{};
+        std::array<ucontext_t, maxThreads> contexts_{};
+        std::function<void(int)> body_;
+
+        std::array<thread_state, maxThreads> threads_{};
+        std::vector<location> locations_;
+        std::unordered_map<const void *, shadow> shadows_;
+        std::vector<event> events_;
+        std::vector<choice> choices_;
+        size_t position_ = 0;
+        size_t steps_ = 0;
+        int preemptions_ = 0;
+        int current_ = 0;
+        std::string failure_;
+    };
+
+    /**
+     * @brief Explores every execution of a scenario.
+     *
+     * @tparam Scenario Default-constructible type with a static `threads` count, a
+     *         `run(int thread)` member and a `finish()` member
+     */
+    template <typename Scenario>
+    result check(const options &opts = options())
+    {
+        explorer ex(opts);
+        return ex.explore<Scenario>();
+    }
+
+    /** Fails the current execution with a message if the condition does not hold. */
+    inline void require(bool condition, const std::string &message)
+    {
+        if (!condition && detail::active != nullptr)
+        {
+            detail::active->fail(message);
+        }
+    }
+
+    /** A fence under the model, standing for std::atomic_thread_fence. */
+    inline void fence(std::memory_order order)
+    {
+        detail::active->fence(order);
+    }
+
+    /**
+     * @brief Drop-in replacement for std::atomic whose operations are explored by the checker.
+     *
+     * @tparam U An integral or pointer type of at most 8 bytes
+     */
+    template <typename U>
+    class atomic
+    {
+    public:
+        static_assert(std::is_trivially_copyable_v<U> && sizeof(U) <= sizeof(uint64_t),
+                      "Model atomics hold trivially copyable values of at most 8 bytes.");
+
+        atomic() : atomic(U()) {}
+        atomic(U value) : id_(detail::active->create(encode(value))) {}
+
+        atomic(const atomic &) = delete;
+        atomic &operator=(const atomic &) = delete;
+
+        U load(std::memory_order order = std::memory_order_seq_cst) const
+        {
+            return decode(detail::active->load(id_, order));
+        }
+
+        void store(U value, std::memory_order order = std::memory_order_seq_cst)
+        {
+            detail::active->store(id_, encode(value), order);
+        }
+
+        U exchange(U value, std::memory_order order = std::memory_order_seq_cst)
+        {
+            const uint64_t bits = encode(value);
+            return decode(detail::active->read_modify_write(id_, order, [bits](uint64_t) { return bits; }));
+        }
+
+        U fetch_add(U delta, std::memory_order order = std::memory_order_seq_cst)
+        {
+            return decode(detail::active->read_modify_write(
+                id_, order, [delta](uint64_t bits) { return encode(static_cast<U>(decode(bits) + delta)); }));
+        }
+
+        operator U() const { return load(); }
+
+        U operator=(U value)
+        {
+            store(value);
+            return value;
+        }
+
+    private:
+        static uint64_t encode(U value)
+        {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(U));
+            return bits;
+        }
+
+        static U decode(uint64_t bits)
+        {
+            U value;
+            std::memcpy(&value, &bits, sizeof(U));
+            return value;
+        }
+
+        size_t id_;
+    };
+
+    /**
+     * @brief An int payload whose construction, reads, writes and destruction are
+     *        checked for data races.
+     */
+    class data
+    {
+    public:
+        data() { write(); }
+        data(int value) : value_(value) { write(); }
+        data(const data &other) : value_(other.get()) { write(); }
+
+        data &operator=(const data &other)
+        {
+            const int value = other.get();
+            write();
+            value_ = value;
+            return *this;
+        }
+
+        ~data() { write(); }
+
+        int get() const
+        {
+            if (detail::active != nullptr)
+            {
+                detail::active->read(this);
+            }
+            return value_;
+        }
+
+    private:
+        void write()
+        {
+            if (detail::active != nullptr)
+            {
+                detail::active->write(this);
+            }
+        }
+
+        int value_ = 0;
+    };
+}
@@ -0,0 +1,167 @@
+#include "spscq_bridge.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    struct Message
+    {
+        uint64_t sequence;
+        double price;
+        uint32_t size;
+    };
+
+    class SocketPair
+    {
+    public:
+        SocketPair() { EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds_), 0); }
+        ~SocketPair()
+        {
+            close_sender();
+            close(fds_[1]);
+        }
+
+        int sender() const { return fds_[0]; }
+        int receiver() const { return fds_[1]; }
+
+        void close_sender()
+        {
+            if (fds_[0] >= 0)
+            {
+                close(fds_[0]);
+                fds_[0] = -1;
+            }
+        }
+
+    private:
+        int fds_[2];
+    };
+
+    void run_bridge(size_t maxBatch, size_t sinkSize, uint64_t count)
+    {
+        SocketPair sockets;
+        spscq<Message> source(64);
+        spscq<Message> sink(sinkSize);
+        std::vector<Message> received;
+
+        spscq_bridge_receiver<Message> receiver(sink, sockets.receiver(), 256);
+
+        std::thread consumer(
+            [&]()
+            {
+                Message message;
+                while (received.size() < count)
+                {
+                    if (sink.try_pop(message))
+                    {
+                        received.push_back(message);
+                    }
+                }
+            });
+
+        {
+            spscq_bridge_sender<Message> sender(source, sockets.sender(), maxBatch);
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                while (!source.try_push(Message{i, i * 0.5, static_cast<uint32_t>(i % 100)}))
+                {
+                }
+            }
+        }
+
+        consumer.join();
+
+        ASSERT_EQ(received.size(), count);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            EXPECT_EQ(received[i].sequence, i);
+            EXPECT_EQ(received[i].price, i * 0.5);
+            EXPECT_EQ(received[i].size, i % 100);
+        }
+        EXPECT_EQ(receiver.messages(), count);
+    }
+}
+
+TEST(SPSCQBridgeTest, ForwardsInOrder)
+{
+    run_bridge(32, 1024, 5000);
+}
+
+TEST(SPSCQBridgeTest, SmallSinkAppliesBackPressure)
+{
+    // Frames larger than the sink are pushed piecewise as the consumer frees slots
+    run_bridge(256, 4, 2000);
+}
+
+TEST(SPSCQBridgeTest, ReceiverFinishesOnClose)
+{
+    SocketPair sockets;
+    spscq<uint64_t> source(16);
+    spscq<uint64_t> sink(16);
+    spscq_bridge_receiver<uint64_t> receiver(sink, sockets.receiver());
+
+    {
+        spscq_bridge_sender<uint64_t> sender(source, sockets.sender());
+        source.try_push(7);
+        source.try_push(8);
+    }
+    sockets.close_sender();
+
+    while (!receiver.finished())
+    {
+        std::this_thread::yield();
+    }
+
+    uint64_t value;
+    EXPECT_TRUE(sink.try_pop(value));
+    EXPECT_EQ(value, 7u);
+    EXPECT_TRUE(sink.try_pop(value));
+    EXPECT_EQ(value, 8u);
+    EXPECT_FALSE(sink.try_pop(value));
+    EXPECT_EQ(receiver.error(), 0);
+}
+
+TEST(SPSCQBridgeTest, ReceiverReportsReset)
+{
+    // A loopback TCP connection, since only TCP lets the peer abort with RST
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+    ASSERT_EQ(listen(listener, 1), 0);
+    ASSERT_EQ(getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length), 0);
+
+    const int peer = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(connect(peer, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+    const int fd = accept(listener, nullptr, nullptr);
+    ASSERT_GE(fd, 0);
+    close(listener);
+
+    spscq<uint64_t> sink(16);
+    {
+        spscq_bridge_receiver<uint64_t> receiver(sink, fd);
+
+        // Closing with a zero linger time sends RST instead of FIN
+        const linger abort{1, 0};
+        ASSERT_EQ(setsockopt(peer, SOL_SOCKET, SO_LINGER, &abort, sizeof(abort)), 0);
+        close(peer);
+
+        while (!receiver.finished())
+        {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(receiver.error(), ECONNRESET);
+    }
+    close(fd);
+}
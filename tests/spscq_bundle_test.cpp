@@ -0,0 +1,125 @@
+#include "spscq_bundle.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+TEST(SPSCQBundleTest, StagedElementsAppearOnPublish)
+{
+    spscq_bundle<int, std::string> bundle(4);
+    int number;
+    std::string text;
+
+    EXPECT_TRUE(bundle.try_push<0>(1));
+    EXPECT_TRUE(bundle.try_push<1>("one"));
+    EXPECT_FALSE(bundle.try_pop<0>(number));
+    EXPECT_EQ(bundle.size<0>(), 0u);
+
+    bundle.publish();
+    EXPECT_EQ(bundle.size<0>(), 1u);
+    EXPECT_EQ(bundle.size<1>(), 1u);
+
+    EXPECT_TRUE(bundle.try_pop<1>(text));
+    EXPECT_EQ(text, "one");
+    EXPECT_TRUE(bundle.try_pop<0>(number));
+    EXPECT_EQ(number, 1);
+    EXPECT_FALSE(bundle.try_pop<0>(number));
+}
+
+TEST(SPSCQBundleTest, FullChannelPublishesAndReleaseFreesSlots)
+{
+    spscq_bundle<int, int> bundle(3);
+    EXPECT_EQ(bundle.capacity(), 4u);
+    int value;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(bundle.try_push<0>(i));
+    }
+    EXPECT_TRUE(bundle.try_push<1>(100));
+
+    // Channel 0 is full: the failed push publishes both channels
+    EXPECT_FALSE(bundle.try_push<0>(4));
+    EXPECT_EQ(bundle.size<0>(), 4u);
+    EXPECT_EQ(bundle.size<1>(), 1u);
+
+    EXPECT_TRUE(bundle.try_pop<0>(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_FALSE(bundle.try_push<0>(4));
+
+    bundle.release();
+    EXPECT_TRUE(bundle.try_push<0>(4));
+    bundle.publish();
+
+    for (int expected = 1; expected <= 4; ++expected)
+    {
+        EXPECT_TRUE(bundle.try_pop<0>(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_TRUE(bundle.try_pop<1>(value));
+    EXPECT_EQ(value, 100);
+}
+
+TEST(SPSCQBundleTest, DestroysRemainingElements)
+{
+    auto counter = std::make_shared<int>(0);
+
+    {
+        spscq_bundle<std::shared_ptr<int>, int> bundle(4);
+        bundle.try_push<0>(counter);
+        bundle.publish();
+        bundle.try_push<0>(counter);
+        EXPECT_EQ(counter.use_count(), 3);
+    }
+
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SPSCQBundleTest, MultithreadedChannels)
+{
+    spscq_bundle<int, long, std::string> bundle(16);
+    const int num_rounds = 10000;
+
+    std::thread producer(
+        [&]()
+        {
+            for (int i = 0; i < num_rounds; ++i)
+            {
+                while (!bundle.try_push<0>(i))
+                    ;
+                while (!bundle.try_push<1>(static_cast<long>(i) * 2))
+                    ;
+                if (i % 7 == 0)
+                {
+                    while (!bundle.try_push<2>(std::to_string(i)))
+                        ;
+                }
+                bundle.publish();
+            }
+        });
+
+    bool ordered = true;
+    int number;
+    long twice;
+    std::string text;
+
+    for (int i = 0; i < num_rounds; ++i)
+    {
+        while (!bundle.try_pop<0>(number))
+            ;
+        while (!bundle.try_pop<1>(twice))
+            ;
+        ordered &= number == i && twice == static_cast<long>(i) * 2;
+        if (i % 7 == 0)
+        {
+            while (!bundle.try_pop<2>(text))
+                ;
+            ordered &= text == std::to_string(i);
+        }
+        bundle.release();
+    }
+
+    producer.join();
+    EXPECT_TRUE(ordered);
+}
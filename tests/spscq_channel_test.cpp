@@ -0,0 +1,128 @@
+#include "spscq_channel.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    template <typename E, typename = void>
+    struct can_push : std::false_type
+    {
+    };
+
+    template <typename E>
+    struct can_push<E, std::void_t<decltype(std::declval<E &>().try_push(0))>> : std::true_type
+    {
+    };
+
+    template <typename E, typename = void>
+    struct can_pop : std::false_type
+    {
+    };
+
+    template <typename E>
+    struct can_pop<E, std::void_t<decltype(std::declval<E &>().try_pop(std::declval<int &>()))>> : std::true_type
+    {
+    };
+}
+
+TEST(SPSCQChannelTest, EndpointsExposeOnlyTheirSide)
+{
+    static_assert(can_push<spscq_producer<int>>::value);
+    static_assert(!can_pop<spscq_producer<int>>::value);
+    static_assert(can_pop<spscq_consumer<int>>::value);
+    static_assert(!can_push<spscq_consumer<int>>::value);
+    static_assert(!std::is_copy_constructible_v<spscq_producer<int>>);
+    static_assert(!std::is_copy_constructible_v<spscq_consumer<int>>);
+}
+
+TEST(SPSCQChannelTest, CapacityRoundsUpToPowerOfTwo)
+{
+    auto [producer, consumer] = make_channel<int>(5);
+    int value;
+
+    EXPECT_EQ(producer.capacity(), 8u);
+    EXPECT_EQ(consumer.capacity(), 8u);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(producer.try_push(i));
+    }
+    EXPECT_FALSE(producer.try_push(8));
+
+    EXPECT_TRUE(consumer.try_pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(producer.try_push(8));
+
+    for (int i = 1; i <= 8; ++i)
+    {
+        EXPECT_TRUE(consumer.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(consumer.try_pop(value));
+    EXPECT_THROW(make_channel<int>(0), std::invalid_argument);
+}
+
+TEST(SPSCQChannelTest, SharedStateOutlivesOneEndpoint)
+{
+    auto counter = std::make_shared<int>(0);
+    auto channel = make_channel<std::shared_ptr<int>>(4);
+
+    {
+        auto producer = std::move(channel.first);
+        producer.try_push(counter);
+        producer.try_push(counter);
+    }
+
+    std::shared_ptr<int> value;
+    EXPECT_TRUE(channel.second.try_pop(value));
+    EXPECT_EQ(value, counter);
+    value.reset();
+    EXPECT_EQ(counter.use_count(), 2);
+
+    channel = make_channel<std::shared_ptr<int>>(4);
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SPSCQChannelTest, MultithreadedProducerConsumer)
+{
+    auto [producer, consumer] = make_channel<std::string>(16);
+    const int num_elements = 1000;
+    std::vector<std::string> consumed_values;
+
+    std::thread producer_thread(
+        [&, p = std::move(producer)]() mutable
+        {
+            for (int i = 0; i < num_elements; ++i)
+            {
+                while (!p.try_push(std::to_string(i)))
+                {
+                }
+            }
+        });
+
+    std::thread consumer_thread(
+        [&, c = std::move(consumer)]() mutable
+        {
+            std::string value;
+            for (int i = 0; i < num_elements; ++i)
+            {
+                while (!c.try_pop(value))
+                {
+                }
+                consumed_values.push_back(value);
+            }
+        });
+
+    producer_thread.join();
+    consumer_thread.join();
+
+    ASSERT_EQ(consumed_values.size(), static_cast<size_t>(num_elements));
+    for (int i = 0; i < num_elements; ++i)
+    {
+        EXPECT_EQ(consumed_values[i], std::to_string(i));
+    }
+}
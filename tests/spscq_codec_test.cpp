@@ -0,0 +1,153 @@
+#include "spscq_codec.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    template <typename T>
+    std::vector<T> round_trip(const std::vector<T> &input, size_t queueSize, uint64_t *bytes = nullptr)
+    {
+        spscq<uint64_t> queue(queueSize);
+        std::vector<T> output;
+
+        {
+            spscq_delta_writer<T> writer(queue);
+            writer.push_n(input.data(), input.size());
+            writer.flush();
+            if (bytes != nullptr)
+            {
+                *bytes = writer.bytes();
+            }
+        }
+
+        spscq_delta_reader<T> reader(queue);
+        for (auto block = reader.try_read(); !block.empty(); block = reader.try_read())
+        {
+            output.insert(output.end(), block.begin(), block.end());
+        }
+        return output;
+    }
+}
+
+TEST(SPSCQCodecTest, PacksAndUnpacksEveryWidth)
+{
+    using namespace spscq_codec_detail;
+
+    for (unsigned width = 0; width <= 64; ++width)
+    {
+        const uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        std::mt19937_64 rng(width);
+
+        for (size_t rows : {1u, 7u, 32u})
+        {
+            std::vector<uint64_t> deltas(rows * lanes);
+            for (auto &delta : deltas)
+            {
+                delta = rng() & mask;
+            }
+
+            std::vector<uint64_t> words(packed_words(rows, width));
+            pack(deltas.data(), rows, width, words.data());
+
+            std::vector<uint64_t> unpacked(rows * lanes);
+            unpack(words.data(), rows, width, unpacked.data());
+            ASSERT_EQ(unpacked, deltas) << "width=" << width << " rows=" << rows;
+        }
+    }
+}
+
+TEST(SPSCQCodecTest, RoundTripsTimestamps)
+{
+    std::vector<uint64_t> timestamps;
+    uint64_t t = 1'700'000'000'000'000'000ull;
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 1000; ++i)
+    {
+        t += rng() % 1000;
+        timestamps.push_back(t);
+    }
+
+    uint64_t bytes = 0;
+    EXPECT_EQ(round_trip(timestamps, 2048, &bytes), timestamps);
+
+    // Differences below 1000 fit in 11 bits after zigzag, instead of 64
+    EXPECT_LT(bytes, timestamps.size() * sizeof(uint64_t) / 4);
+}
+
+TEST(SPSCQCodecTest, RoundTripsSignedAndExtremeValues)
+{
+    const std::vector<int64_t> prices{100, 99, 101, -5, 0, std::numeric_limits<int64_t>::max(),
+                                      std::numeric_limits<int64_t>::min(), 42, 42, 42};
+    EXPECT_EQ(round_trip(prices, 256), prices);
+
+    const std::vector<uint32_t> constant(300, 7u);
+    uint64_t bytes = 0;
+    EXPECT_EQ(round_trip(constant, 256, &bytes), constant);
+    // Only headers and first values: three blocks of two words
+    EXPECT_EQ(bytes, 3 * 2 * sizeof(uint64_t));
+}
+
+TEST(SPSCQCodecTest, ReaderWaitsForIncompleteBlock)
+{
+    spscq<uint64_t> queue(64);
+    spscq_delta_writer<uint64_t> writer(queue);
+    spscq_delta_reader<uint64_t> reader(queue);
+
+    writer.push(1);
+    EXPECT_TRUE(reader.try_read().empty());
+
+    writer.push(5);
+    writer.push(3);
+    writer.flush();
+
+    uint64_t values[4];
+    EXPECT_EQ(reader.try_pop_n(values, 2), 2u);
+    EXPECT_EQ(values[0], 1u);
+    EXPECT_EQ(values[1], 5u);
+    EXPECT_EQ(reader.try_pop_n(values, 4), 1u);
+    EXPECT_EQ(values[0], 3u);
+    EXPECT_EQ(reader.try_pop_n(values, 4), 0u);
+}
+
+TEST(SPSCQCodecTest, MultithreadedSmallQueue)
+{
+    // Blocks are larger than the queue, so they always arrive in pieces
+    spscq<uint64_t> queue(16);
+    const uint64_t num_values = 5000;
+
+    std::thread producer(
+        [&]()
+        {
+            spscq_delta_writer<uint64_t> writer(queue);
+            std::mt19937_64 rng(2);
+            uint64_t value = 0;
+            for (uint64_t i = 0; i < num_values; ++i)
+            {
+                value += rng() % (i % 3 == 0 ? 1u << 20 : 16u);
+                writer.push(value);
+            }
+        });
+
+    spscq_delta_reader<uint64_t> reader(queue);
+    std::mt19937_64 rng(2);
+    uint64_t expected = 0;
+    uint64_t received = 0;
+    uint64_t values[64];
+
+    while (received < num_values)
+    {
+        const size_t n = reader.try_pop_n(values, 64);
+        for (size_t i = 0; i < n; ++i, ++received)
+        {
+            expected += rng() % (received % 3 == 0 ? 1u << 20 : 16u);
+            EXPECT_EQ(values[i], expected);
+        }
+    }
+
+    producer.join();
+}
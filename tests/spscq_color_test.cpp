@@ -0,0 +1,79 @@
+#include "spscq.hpp"
+#include "spscq_color.hpp"
+
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+
+TEST(SPSCQColorTest, AllocatorStaggersByColor)
+{
+    colored_allocator<int> plain(0);
+    colored_allocator<int> colored(3);
+
+    int *a = plain.allocate(1024);
+    int *b = colored.allocate(1024);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % cache_color::pageSize, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % cache_color::pageSize, 3 * cache_color::lineSize);
+
+    plain.deallocate(a, 1024);
+    colored.deallocate(b, 1024);
+}
+
+TEST(SPSCQColorTest, ColorsWrapAround)
+{
+    EXPECT_EQ(cache_color::offset(cache_color::defaultColors + 2), 2 * cache_color::lineSize);
+    EXPECT_EQ(cache_color::offset(5, 4), cache_color::lineSize);
+    EXPECT_EQ(cache_color::offset(5, 1), 0u);
+}
+
+TEST(SPSCQColorTest, ColoredQueue)
+{
+    using queue_type = spscq<int, colored_allocator<int>>;
+
+    auto queue = make_colored<queue_type>(2, cache_color::defaultColors, 16, colored_allocator<int>(2));
+    int value;
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(queue.get()) % cache_color::pageSize, 2 * cache_color::step<queue_type>);
+
+    EXPECT_TRUE(queue->try_push(42));
+    EXPECT_TRUE(queue->try_pop(value));
+    EXPECT_EQ(value, 42);
+}
+
+TEST(SPSCQColorTest, AdjacentColorsOfAlignedQueuesAreDistinct)
+{
+    using queue_type = spscq<int>;
+
+    std::vector<colored_ptr<queue_type>> queues;
+    std::set<uintptr_t> offsets;
+    for (size_t color = 0; color < 8; ++color)
+    {
+        queues.push_back(make_colored<queue_type>(color, cache_color::defaultColors, 16));
+        const uintptr_t address = reinterpret_cast<uintptr_t>(queues.back().get());
+        EXPECT_EQ(address % alignof(queue_type), 0u);
+        offsets.insert(address % cache_color::pageSize);
+    }
+
+    EXPECT_EQ(offsets.size(), queues.size());
+}
+
+TEST(SPSCQColorTest, DefaultColorsOfAlignedQueuesStayWithinAPage)
+{
+    using queue_type = spscq<int>;
+    constexpr size_t distinct = cache_color::colors_of<queue_type>;
+
+    std::vector<colored_ptr<queue_type>> queues;
+    std::set<uintptr_t> offsets;
+    for (size_t color = 0; color < cache_color::defaultColors; ++color)
+    {
+        queues.push_back(make_colored<queue_type>(color, cache_color::defaultColors, 16));
+        const size_t offset = queues.back().get_deleter().offset;
+        EXPECT_LT(offset, cache_color::pageSize);
+        EXPECT_EQ(offset, color % distinct * cache_color::step<queue_type>);
+        offsets.insert(reinterpret_cast<uintptr_t>(queues.back().get()) % cache_color::pageSize);
+    }
+
+    // defaultColors fold onto the colors_of offsets a page holds, 32 at 128-byte alignment
+    EXPECT_EQ(offsets.size(), distinct);
+}
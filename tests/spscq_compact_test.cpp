@@ -0,0 +1,94 @@
+#include "spscq_compact.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SPSCQCompactTest, FitsInHalfACacheLine)
+{
+    EXPECT_EQ(sizeof(spscq_compact<int>), 32u);
+    EXPECT_EQ(alignof(spscq_compact<int>), 32u);
+}
+
+TEST(SPSCQCompactTest, RejectsInvalidSize)
+{
+    EXPECT_THROW(spscq_compact<int>(0), std::invalid_argument);
+}
+
+TEST(SPSCQCompactTest, WrapAround)
+{
+    spscq_compact<int> queue(4);
+    int value;
+
+    queue.try_push(1);
+    queue.try_push(2);
+    queue.try_push(3);
+    EXPECT_FALSE(queue.try_push(4));
+    queue.try_pop(value);
+
+    EXPECT_TRUE(queue.try_push(4));
+    EXPECT_EQ(queue.size(), 3u);
+
+    for (int expected = 2; expected <= 4; ++expected)
+    {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQCompactTest, DestroysRemainingElements)
+{
+    auto counter = std::make_shared<int>(0);
+
+    {
+        spscq_compact<std::shared_ptr<int>> queue(4);
+        queue.try_push(counter);
+        queue.try_push(counter);
+        EXPECT_EQ(counter.use_count(), 3);
+    }
+
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SPSCQCompactTest, MultithreadedProducerConsumer)
+{
+    spscq_compact<int> queue(16);
+    const int num_elements = 1000;
+    std::vector<int> consumed_values;
+
+    std::thread producer(
+        [&]()
+        {
+            for (int i = 0; i < num_elements; ++i)
+            {
+                while (!queue.try_push(i))
+                {
+                }
+            }
+        });
+
+    std::thread consumer(
+        [&]()
+        {
+            int value;
+            for (int i = 0; i < num_elements; ++i)
+            {
+                while (!queue.try_pop(value))
+                {
+                }
+                consumed_values.push_back(value);
+            }
+        });
+
+    producer.join();
+    consumer.join();
+
+    ASSERT_EQ(consumed_values.size(), static_cast<size_t>(num_elements));
+    for (int i = 0; i < num_elements; ++i)
+    {
+        EXPECT_EQ(consumed_values[i], i);
+    }
+}
@@ -0,0 +1,95 @@
+#include "spscq_fanout.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SPSCQFanoutTest, RejectsInvalidArguments)
+{
+    auto identity = [](int x) { return x; };
+
+    EXPECT_THROW((spscq_fanout<int, int>(0, 8, 8, identity)), std::invalid_argument);
+    EXPECT_THROW((spscq_fanout<int, int>(2, 8, 0, identity)), std::invalid_argument);
+}
+
+TEST(SPSCQFanoutTest, ReleasesInSubmissionOrder)
+{
+    const int num_elements = 500;
+    spscq_fanout<int, std::string> fanout(3, 8, 16,
+                                          [](int x)
+                                          {
+                                              // Uneven work so results complete out of order
+                                              if (x % 7 == 0)
+                                              {
+                                                  std::this_thread::sleep_for(std::chrono::microseconds(50));
+                                              }
+                                              return std::to_string(x);
+                                          });
+
+    std::vector<std::string> received;
+    int submitted = 0;
+    std::string value;
+
+    while (received.size() < static_cast<size_t>(num_elements))
+    {
+        while (submitted < num_elements && fanout.try_submit(submitted))
+        {
+            ++submitted;
+        }
+
+        while (fanout.try_receive(value))
+        {
+            received.push_back(value);
+        }
+    }
+
+    for (int i = 0; i < num_elements; ++i)
+    {
+        EXPECT_EQ(received[i], std::to_string(i));
+    }
+}
+
+TEST(SPSCQFanoutTest, StalledWorkerAppliesBackPressure)
+{
+    std::atomic<bool> release{false};
+    const size_t window = 8;
+
+    spscq_fanout<int, int> fanout(2, 64, window,
+                                  [&](int x)
+                                  {
+                                      if (x == 0)
+                                      {
+                                          while (!release.load())
+                                          {
+                                              std::this_thread::yield();
+                                          }
+                                      }
+                                      return x * 2;
+                                  });
+
+    size_t submitted = 0;
+    while (fanout.try_submit(static_cast<int>(submitted)))
+    {
+        ++submitted;
+    }
+    EXPECT_EQ(submitted, window);
+
+    int value;
+    EXPECT_FALSE(fanout.try_receive(value));
+
+    release.store(true);
+    for (size_t i = 0; i < window; ++i)
+    {
+        while (!fanout.try_receive(value))
+        {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(value, static_cast<int>(i) * 2);
+    }
+
+    // Releasing results reopens the window
+    EXPECT_TRUE(fanout.try_submit(100));
+}
@@ -0,0 +1,141 @@
+#include "spscq_merge.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Tick
+    {
+        long timestamp;
+        int feed;
+    };
+
+    struct TimestampOf
+    {
+        long operator()(const Tick &tick) const { return tick.timestamp; }
+    };
+
+    using merge_type = spscq_merge<Tick, TimestampOf>;
+}
+
+TEST(SPSCQMergeTest, EmitsInTimestampOrder)
+{
+    spscq<Tick> a(8), b(8), c(8);
+    merge_type merge({&a, &b, &c});
+
+    for (long ts : {1, 4, 7})
+        a.try_push(Tick{ts, 0});
+    for (long ts : {2, 5, 8})
+        b.try_push(Tick{ts, 1});
+    for (long ts : {3, 6, 9})
+        c.try_push(Tick{ts, 2});
+    merge.close(0);
+    merge.close(1);
+    merge.close(2);
+
+    std::vector<long> emitted;
+    merge.emit_all(
+        [&](size_t input, Tick &tick)
+        {
+            EXPECT_EQ(static_cast<int>(input), tick.feed);
+            emitted.push_back(tick.timestamp);
+        });
+
+    EXPECT_EQ(emitted, (std::vector<long>{1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_TRUE(a.empty() && b.empty() && c.empty());
+}
+
+TEST(SPSCQMergeTest, WaitsForSlowInput)
+{
+    spscq<Tick> fast(8), slow(8);
+    merge_type merge({&fast, &slow});
+    std::vector<long> emitted;
+    auto collect = [&](size_t, Tick &tick) { emitted.push_back(tick.timestamp); };
+
+    fast.try_push(Tick{10, 0});
+    fast.try_push(Tick{20, 0});
+
+    // Nothing is known about the slow input yet
+    EXPECT_EQ(merge.emit_all(collect), 0u);
+
+    slow.try_push(Tick{15, 1});
+    EXPECT_EQ(merge.emit_all(collect), 2u);
+    // The slow input is empty again and its watermark (15) is below 20
+    EXPECT_EQ(emitted, (std::vector<long>{10, 15}));
+
+    merge.set_watermark(1, 25);
+    EXPECT_EQ(merge.emit_all(collect), 1u);
+    EXPECT_EQ(emitted, (std::vector<long>{10, 15, 20}));
+}
+
+TEST(SPSCQMergeTest, ClosedInputDoesNotBlock)
+{
+    spscq<Tick> a(8), b(8);
+    merge_type merge({&a, &b});
+    std::vector<long> emitted;
+
+    a.try_push(Tick{1, 0});
+    a.try_push(Tick{2, 0});
+    merge.close(1);
+
+    EXPECT_EQ(merge.emit_all([&](size_t, Tick &tick) { emitted.push_back(tick.timestamp); }), 2u);
+    EXPECT_EQ(emitted, (std::vector<long>{1, 2}));
+}
+
+TEST(SPSCQMergeTest, MultithreadedFeeds)
+{
+    const size_t feeds = 5;
+    const long ticks = 500;
+    std::vector<std::unique_ptr<spscq<Tick>>> queues;
+    std::vector<spscq<Tick> *> inputs;
+    for (size_t i = 0; i < feeds; ++i)
+    {
+        queues.push_back(std::make_unique<spscq<Tick>>(16));
+        inputs.push_back(queues.back().get());
+    }
+
+    merge_type merge(inputs);
+
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < feeds; ++i)
+    {
+        producers.emplace_back(
+            [&, i]()
+            {
+                for (long t = 0; t < ticks; ++t)
+                {
+                    while (!queues[i]->try_push(Tick{t * static_cast<long>(feeds) + static_cast<long>(i), static_cast<int>(i)}))
+                    {
+                    }
+                }
+            });
+    }
+
+    std::vector<long> emitted;
+    std::vector<long> perFeed(feeds, 0);
+    while (emitted.size() < feeds * ticks)
+    {
+        merge.emit_all(
+            [&](size_t input, Tick &tick)
+            {
+                emitted.push_back(tick.timestamp);
+                // A finished feed must be closed, or its watermark holds back the others
+                if (++perFeed[input] == ticks)
+                {
+                    merge.close(input);
+                }
+            });
+    }
+
+    for (auto &t : producers)
+    {
+        t.join();
+    }
+
+    for (size_t i = 0; i < emitted.size(); ++i)
+    {
+        EXPECT_EQ(emitted[i], static_cast<long>(i));
+    }
+}
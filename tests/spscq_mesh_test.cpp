@@ -0,0 +1,159 @@
+#include "spscq_mesh.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(SPSCQArenaTest, AlignedBumpAllocation)
+{
+    spscq_arena arena(1024);
+
+    void *a = arena.allocate(3, 1);
+    void *b = arena.allocate(8, 64);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+    EXPECT_GT(static_cast<char *>(b), static_cast<char *>(a));
+    EXPECT_EQ(arena.capacity() % spscq_arena::hugePageSize, 0u);
+}
+
+TEST(SPSCQArenaTest, ThrowsWhenExhausted)
+{
+    spscq_arena arena(1);
+
+    EXPECT_THROW(arena.allocate(arena.capacity() + 1, 1), std::bad_alloc);
+    arena.allocate(arena.capacity(), 1);
+    EXPECT_THROW(arena.allocate(1, 1), std::bad_alloc);
+}
+
+TEST(SPSCQMeshTest, RejectsInvalidArguments)
+{
+    EXPECT_THROW(spscq_mesh<int>(1, 16), std::invalid_argument);
+    EXPECT_THROW(spscq_mesh<int>(4, 0), std::invalid_argument);
+}
+
+TEST(SPSCQMeshTest, InboundChannelsAreAdjacent)
+{
+    spscq_mesh<int> mesh(4, 16);
+    using queue_type = spscq_mesh<int>::queue_type;
+
+    for (size_t to = 0; to < 4; ++to)
+    {
+        queue_type *first = &mesh.channel(to == 0 ? 1 : 0, to);
+        size_t k = 0;
+        for (size_t from = 0; from < 4; ++from)
+        {
+            if (from != to)
+            {
+                EXPECT_EQ(&mesh.channel(from, to), first + k++);
+            }
+        }
+    }
+}
+
+TEST(SPSCQMeshTest, RingBuffersStartOnSeparateLines)
+{
+    // 3-byte elements, so unpadded rings would end mid-line
+    struct small
+    {
+        char bytes[3];
+    };
+    spscq_mesh<small> mesh(3, 5);
+
+    for (size_t from = 0; from < 3; ++from)
+    {
+        for (size_t to = 0; to < 3; ++to)
+        {
+            if (from != to)
+            {
+                auto &queue = mesh.channel(from, to);
+                EXPECT_TRUE(queue.try_push(small{}));
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(queue.front()) % spscq_config::interferenceSize, 0u);
+            }
+        }
+    }
+}
+
+TEST(SPSCQMeshTest, SendAndPollAll)
+{
+    spscq_mesh<int> mesh(3, 4);
+    auto w0 = mesh.worker(0);
+    auto w1 = mesh.worker(1);
+    auto w2 = mesh.worker(2);
+
+    EXPECT_TRUE(w0.try_send(2, 10));
+    EXPECT_TRUE(w1.try_send(2, 11));
+    EXPECT_TRUE(w1.try_send(2, 12));
+    EXPECT_TRUE(w1.try_send(2, 13));
+    // Channel 1 -> 2 is full, 1 -> 0 is not
+    EXPECT_FALSE(w1.try_send(2, 14));
+    EXPECT_TRUE(w1.try_send(0, 15));
+
+    std::vector<std::pair<size_t, int>> received;
+    size_t count = w2.poll_all([&](size_t from, int &msg) { received.emplace_back(from, msg); });
+
+    EXPECT_EQ(count, 4u);
+    EXPECT_EQ(received, (std::vector<std::pair<size_t, int>>{{0, 10}, {1, 11}, {1, 12}, {1, 13}}));
+    EXPECT_EQ(w2.poll_all([](size_t, int &) {}), 0u);
+}
+
+TEST(SPSCQMeshTest, MultithreadedAllToAll)
+{
+    const size_t workers = 3;
+    const int messages = 200;
+    spscq_mesh<int> mesh(workers, 8);
+    std::vector<std::vector<int>> received(workers * workers);
+
+    std::vector<std::thread> threads;
+    for (size_t self = 0; self < workers; ++self)
+    {
+        threads.emplace_back(
+            [&, self]()
+            {
+                auto ep = mesh.worker(self);
+                const size_t expected = (workers - 1) * messages;
+                size_t got = 0;
+                auto handle = [&](size_t from, int &msg)
+                {
+                    received[from * workers + self].push_back(msg);
+                    ++got;
+                };
+
+                for (int i = 0; i < messages; ++i)
+                {
+                    for (size_t to = 0; to < workers; ++to)
+                    {
+                        if (to != self)
+                        {
+                            while (!ep.try_send(to, i))
+                            {
+                                ep.poll_all(handle);
+                            }
+                        }
+                    }
+                }
+
+                while (got < expected)
+                {
+                    ep.poll_all(handle);
+                }
+            });
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    for (size_t from = 0; from < workers; ++from)
+    {
+        for (size_t to = 0; to < workers; ++to)
+        {
+            const auto &values = received[from * workers + to];
+            ASSERT_EQ(values.size(), from == to ? 0u : static_cast<size_t>(messages));
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                EXPECT_EQ(values[i], static_cast<int>(i));
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#include "spscq_mirrored.hpp"
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SPSCQMirroredTest, BufferIsMappedTwice)
+{
+    mirrored_buffer buffer(1);
+    std::byte *data = buffer.data();
+
+    data[0] = std::byte{42};
+    data[buffer.size() - 1] = std::byte{7};
+
+    EXPECT_EQ(data[buffer.size()], std::byte{42});
+    EXPECT_EQ(data[2 * buffer.size() - 1], std::byte{7});
+}
+
+TEST(SPSCQMirroredTest, CapacitySpansWholePages)
+{
+    spscq_mirrored<uint64_t> queue(3);
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    EXPECT_EQ(queue.capacity(), page / sizeof(uint64_t));
+    EXPECT_THROW(spscq_mirrored<uint64_t>(0), std::invalid_argument);
+}
+
+TEST(SPSCQMirroredTest, WindowsStayContiguousAcrossTheWrap)
+{
+    spscq_mirrored<uint32_t> queue(1);
+    const size_t capacity = queue.capacity();
+    std::vector<uint32_t> scratch(capacity);
+
+    // Move the indices close to the end of the ring
+    EXPECT_EQ(queue.try_push_n(scratch.data(), capacity - 3), capacity - 3);
+    EXPECT_EQ(queue.try_pop_n(scratch.data(), capacity), capacity - 3);
+
+    auto [slot, free] = queue.write_window(capacity);
+    ASSERT_EQ(free, capacity);
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        slot[i] = i;
+    }
+    queue.commit_write(10);
+
+    auto [data, available] = queue.read_window();
+    ASSERT_EQ(available, 10u);
+    EXPECT_EQ(data, slot);
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(data[i], i);
+    }
+    queue.commit_read(10);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQMirroredTest, ByteRecordsAreNeverSplit)
+{
+    spscq_mirrored<char> queue(1);
+    const size_t capacity = queue.capacity();
+    std::string record = "variable-length record";
+    std::vector<char> sink(capacity);
+
+    size_t pushed = 0;
+    while (pushed + record.size() <= 3 * capacity)
+    {
+        auto [slot, free] = queue.write_window(record.size());
+        ASSERT_GE(free, record.size());
+        std::memcpy(slot, record.data(), record.size());
+        queue.commit_write(record.size());
+        pushed += record.size();
+
+        auto [data, available] = queue.read_window();
+        ASSERT_EQ(available, record.size());
+        EXPECT_EQ(std::string(data, available), record);
+        queue.commit_read(available);
+    }
+}
+
+TEST(SPSCQMirroredTest, MultithreadedBulkTransfer)
+{
+    spscq_mirrored<uint64_t> queue(1);
+    const uint64_t num_elements = 100000;
+    bool ordered = true;
+
+    std::thread producer(
+        [&]()
+        {
+            uint64_t batch[37];
+            for (uint64_t next = 0; next < num_elements;)
+            {
+                size_t n = 0;
+                while (n < 37 && next + n < num_elements)
+                {
+                    batch[n] = next + n;
+                    ++n;
+                }
+                next += queue.try_push_n(batch, n);
+            }
+        });
+
+    std::thread consumer(
+        [&]()
+        {
+            uint64_t batch[64];
+            for (uint64_t expected = 0; expected < num_elements;)
+            {
+                const size_t n = queue.try_pop_n(batch, 64);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    ordered = ordered && batch[i] == expected++;
+                }
+            }
+        });
+
+    producer.join();
+    consumer.join();
+
+    EXPECT_TRUE(ordered);
+}
@@ -0,0 +1,372 @@
+#include "model_checker.hpp"
+
+#define SPSCQ_ATOMIC model::atomic
+#include "spscq.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+    using queue_type = spscq<model::data>;
+
+    /** Checks that the consumer saw a FIFO prefix of what the producer pushed, then drains the rest. */
+    template <typename Queue>
+    void check_fifo(Queue &queue, const std::vector<int> &pushed, std::vector<int> popped)
+    {
+        model::data value;
+        while (queue.try_pop(value))
+        {
+            popped.push_back(value.get());
+        }
+        model::require(popped == pushed, "popped elements differ from pushed elements");
+    }
+
+    /** Three elements through a single-slot queue, so slots are reused after being popped. */
+    struct PushPop
+    {
+        static constexpr int threads = 2;
+
+        queue_type queue{2};
+        std::vector<int> pushed, popped;
+
+        void run(int thread)
+        {
+            if (thread == 1)
+            {
+                for (int v = 1; v <= 3; ++v)
+                {
+                    if (queue.try_push(model::data(v)))
+                    {
+                        pushed.push_back(v);
+                    }
+                }
+            }
+            else
+            {
+                model::data value;
+                for (int i = 0; i < 3; ++i)
+                {
+                    if (queue.try_pop(value))
+                    {
+                        popped.push_back(value.get());
+                    }
+                }
+            }
+        }
+
+        void finish() { check_fifo(queue, pushed, popped); }
+    };
+
+    struct BulkPushPop
+    {
+        static constexpr int threads = 2;
+
+        queue_type queue{4};
+        std::vector<int> pushed, popped;
+
+        void run(int thread)
+        {
+            if (thread == 1)
+            {
+                const model::data values[] = {1, 2, 3, 4};
+                for (size_t done = 0, round = 0; round < 2 && done < 4; ++round)
+                {
+                    const size_t n = queue.try_push_n(values + done, 4 - done);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        pushed.push_back(static_cast<int>(done + i + 1));
+                    }
+                    done += n;
+                }
+            }
+            else
+            {
+                model::data values[3];
+                for (int round = 0; round < 2; ++round)
+                {
+                    const size_t n = queue.try_pop_n(values, 3);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        popped.push_back(values[i].get());
+                    }
+                }
+            }
+        }
+
+        void finish() { check_fifo(queue, pushed, popped); }
+    };
+
+    struct FrontPop
+    {
+        static constexpr int threads = 2;
+
+        queue_type queue{2};
+        std::vector<int> pushed, popped;
+
+        void run(int thread)
+        {
+            if (thread == 1)
+            {
+                for (int v = 1; v <= 2; ++v)
+                {
+                    if (queue.try_push(model::data(v)))
+                    {
+                        pushed.push_back(v);
+                    }
+                }
+            }
+            else
+            {
+                for (int i = 0; i < 2; ++i)
+                {
+                    if (model::data *value = queue.front())
+                    {
+                        popped.push_back(value->get());
+                        queue.pop();
+                    }
+                }
+            }
+        }
+
+        void finish() { check_fifo(queue, pushed, popped); }
+    };
+
+    /** The back inserter spins while the queue is full, so the queue is sized to never fill up. */
+    struct BackInserterDrain
+    {
+        static constexpr int threads = 2;
+
+        queue_type queue{4};
+        std::vector<int> popped;
+
+        void run(int thread)
+        {
+            if (thread == 1)
+            {
+                const model::data values[] = {1, 2, 3};
+                std::copy(values, values + 3, queue.back_inserter(2));
+            }
+            else
+            {
+                for (int round = 0; round < 2; ++round)
+                {
+                    for (model::data &value : queue.drain())
+                    {
+                        popped.push_back(value.get());
+                    }
+                }
+            }
+        }
+
+        void finish() { check_fifo(queue, {1, 2, 3}, popped); }
+    };
+
+    struct DeferredPop
+    {
+        static constexpr int threads = 2;
+
+        queue_type queue{3};
+        std::vector<int> pushed, popped;
+
+        void run(int thread)
+        {
+            if (thread == 1)
+            {
+                for (int v = 1; v <= 3; ++v)
+                {
+                    if (queue.try_push(model::data(v)))
+                    {
+                        pushed.push_back(v);
+                    }
+                }
+            }
+            else
+            {
+                model::data value;
+                for (int i = 0; i < 3; ++i)
+                {
+                    if (queue.try_pop_deferred(value))
+                    {
+                        popped.push_back(value.get());
+                    }
+                }
+                queue.reclaim();
+            }
+        }
+
+        void finish() { check_fifo(queue, pushed, popped); }
+    };
+
+    struct BatchedMaskPushPop
+    {
+        static constexpr int threads = 2;
+
+        spscq<model::data, std::allocator<model::data>, mask_indexing, batched_publication<2>> queue{4};
+        std::vector<int> pushed, popped;
+
+        void run(int thread)
+        {
+            if (thread == 1)
+            {
+                for (int v = 1; v <= 3; ++v)
+                {
+                    if (queue.try_push(model::data(v)))
+                    {
+                        pushed.push_back(v);
+                    }
+                }
+                queue.flush();
+            }
+            else
+            {
+                model::data value;
+                for (int i = 0; i < 2; ++i)
+                {
+                    if (queue.try_pop(value))
+                    {
+                        popped.push_back(value.get());
+                    }
+                }
+            }
+        }
+
+        void finish() { check_fifo(queue, pushed, popped); }
+    };
+
+    /** Batched single pushes around a bulk push, which must resume from the bulk push's end. */
+    struct BatchedBulkPushPop
+    {
+        static constexpr int threads = 2;
+
+        spscq<model::data, std::allocator<model::data>, wrap_indexing, batched_publication<2>> queue{4};
+        std::vector<int> pushed, popped;
+
+        void run(int thread)
+        {
+            if (thread == 1)
+            {
+                if (queue.try_push(model::data(1)))
+                {
+                    pushed.push_back(1);
+                }
+                const model::data values[] = {2};
+                if (queue.try_push_n(values, 1) == 1)
+                {
+                    pushed.push_back(2);
+                }
+                if (queue.try_push(model::data(3)))
+                {
+                    pushed.push_back(3);
+                }
+                queue.flush();
+            }
+            else
+            {
+                model::data value;
+                for (int i = 0; i < 2; ++i)
+                {
+                    if (queue.try_pop(value))
+                    {
+                        popped.push_back(value.get());
+                    }
+                }
+            }
+        }
+
+        void finish() { check_fifo(queue, pushed, popped); }
+    };
+
+    /** A one-slot handoff whose flag is published with the given orderings, to test the checker itself. */
+    template <std::memory_order Publish, std::memory_order Observe, bool Fences>
+    struct Handoff
+    {
+        static constexpr int threads = 2;
+
+        model::atomic<int> ready{0};
+        model::data payload;
+        int seen = 0;
+
+        void run(int thread)
+        {
+            if (thread == 1)
+            {
+                payload = model::data(42);
+                if (Fences)
+                {
+                    model::fence(std::memory_order_release);
+                }
+                ready.store(1, Publish);
+            }
+            else if (ready.load(Observe) == 1)
+            {
+                if (Fences)
+                {
+                    model::fence(std::memory_order_acquire);
+                }
+                seen = payload.get();
+            }
+        }
+
+        void finish() { model::require(seen == 0 || seen == 42, "payload read before it was written"); }
+    };
+
+    void expect_verified(const model::result &result)
+    {
+        EXPECT_TRUE(result.ok) << result.report;
+        EXPECT_TRUE(result.complete);
+        EXPECT_GT(result.executions, 1u);
+    }
+}
+
+TEST(SPSCQModelTest, PushPop)
+{
+    expect_verified(model::check<PushPop>());
+}
+
+TEST(SPSCQModelTest, BulkPushPop)
+{
+    expect_verified(model::check<BulkPushPop>());
+}
+
+TEST(SPSCQModelTest, FrontPop)
+{
+    expect_verified(model::check<FrontPop>());
+}
+
+TEST(SPSCQModelTest, BackInserterDrain)
+{
+    expect_verified(model::check<BackInserterDrain>());
+}
+
+TEST(SPSCQModelTest, DeferredPop)
+{
+    expect_verified(model::check<DeferredPop>());
+}
+
+TEST(SPSCQModelTest, BatchedMaskPushPop)
+{
+    expect_verified(model::check<BatchedMaskPushPop>());
+}
+
+TEST(SPSCQModelTest, BatchedBulkPushPop)
+{
+    expect_verified(model::check<BatchedBulkPushPop>());
+}
+
+TEST(SPSCQModelTest, CheckerAcceptsReleaseAcquire)
+{
+    expect_verified(model::check<Handoff<std::memory_order_release, std::memory_order_acquire, false>>());
+    expect_verified(model::check<Handoff<std::memory_order_relaxed, std::memory_order_relaxed, true>>());
+}
+
+TEST(SPSCQModelTest, CheckerFindsRelaxedPublication)
+{
+    const model::result relaxedStore = model::check<Handoff<std::memory_order_relaxed, std::memory_order_acquire, false>>();
+    EXPECT_FALSE(relaxedStore.ok);
+    EXPECT_NE(relaxedStore.report.find("data race"), std::string::npos) << relaxedStore.report;
+
+    const model::result relaxedLoad = model::check<Handoff<std::memory_order_release, std::memory_order_relaxed, false>>();
+    EXPECT_FALSE(relaxedLoad.ok);
+}
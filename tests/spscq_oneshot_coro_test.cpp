@@ -0,0 +1,83 @@
+#include "spscq_oneshot.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+#ifndef SPSCQ_ONESHOT_COROUTINES
+#error "This test must be compiled as C++20 with coroutine support."
+#endif
+
+namespace
+{
+    /** Coroutine that starts at once and frees itself when it finishes. */
+    struct detached
+    {
+        struct promise_type
+        {
+            detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+    detached receive_into(spscq_oneshot<std::string> &channel, std::string &value, std::thread::id &resumedOn)
+    {
+        value = co_await channel;
+        resumedOn = std::this_thread::get_id();
+    }
+}
+
+TEST(SPSCQOneshotCoroTest, AwaitSentValue)
+{
+    spscq_oneshot<std::string> channel;
+    std::string value;
+    std::thread::id resumedOn;
+
+    channel.send("hello");
+    receive_into(channel, value, resumedOn);
+
+    // The value was ready, so the coroutine never suspended
+    EXPECT_EQ(value, "hello");
+    EXPECT_FALSE(channel.is_ready());
+}
+
+TEST(SPSCQOneshotCoroTest, AwaitSuspendsUntilSend)
+{
+    spscq_oneshot<std::string> channel;
+    std::string value;
+    std::thread::id resumedOn;
+
+    receive_into(channel, value, resumedOn);
+    EXPECT_TRUE(value.empty());
+    EXPECT_EQ(resumedOn, std::thread::id());
+
+    channel.send("hello");
+    EXPECT_EQ(value, "hello");
+    EXPECT_FALSE(channel.is_ready());
+
+    // The channel can be awaited again once received
+    receive_into(channel, value, resumedOn);
+    channel.send("again");
+    EXPECT_EQ(value, "again");
+}
+
+TEST(SPSCQOneshotCoroTest, ResumesOnSenderThread)
+{
+    spscq_oneshot<std::string> channel;
+    std::string value;
+    std::thread::id resumedOn;
+
+    receive_into(channel, value, resumedOn);
+
+    std::thread sender([&] { channel.send("hello"); });
+    const std::thread::id senderId = sender.get_id();
+    sender.join();
+
+    EXPECT_EQ(value, "hello");
+    EXPECT_EQ(resumedOn, senderId);
+}
@@ -0,0 +1,91 @@
+#include "spscq_oneshot.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+TEST(SPSCQOneshotTest, SendThenReceive)
+{
+    spscq_oneshot<std::string> channel;
+    std::string value;
+
+    EXPECT_FALSE(channel.try_receive(value));
+
+    channel.send("hello");
+    EXPECT_TRUE(channel.is_ready());
+    EXPECT_TRUE(channel.try_receive(value));
+    EXPECT_EQ(value, "hello");
+
+    // Receiving returns the channel to its empty state
+    EXPECT_FALSE(channel.is_ready());
+    channel.send("again");
+    EXPECT_EQ(channel.receive_spin(), "again");
+}
+
+TEST(SPSCQOneshotTest, UnreceivedValueIsDestroyed)
+{
+    auto counter = std::make_shared<int>(0);
+
+    {
+        spscq_oneshot<std::shared_ptr<int>> channel;
+        channel.send(counter);
+        EXPECT_EQ(counter.use_count(), 2);
+    }
+
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SPSCQOneshotTest, SpinAcrossThreads)
+{
+    spscq_oneshot<int> request;
+    spscq_oneshot<int> response;
+
+    std::thread server(
+        [&]()
+        {
+            int x = request.receive_spin();
+            response.send(x * 2);
+        });
+
+    request.send(21);
+    EXPECT_EQ(response.receive_spin(), 42);
+    server.join();
+}
+
+TEST(SPSCQOneshotTest, FutexAcrossThreads)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        spscq_oneshot<int> channel;
+
+        std::thread sender([&]() { channel.send(i); });
+
+        EXPECT_EQ(channel.receive_futex(), i);
+        sender.join();
+    }
+}
+
+TEST(SPSCQOneshotTest, PoolRecyclesChannels)
+{
+    spscq_oneshot_pool<int> pool(2);
+
+    auto *a = pool.acquire();
+    auto *b = pool.acquire();
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(pool.acquire(), nullptr);
+
+    a->send(1);
+    EXPECT_EQ(a->receive_spin(), 1);
+    pool.release(a);
+    // An unreceived value is discarded on release
+    b->send(2);
+    pool.release(b);
+
+    EXPECT_EQ(pool.available(), 2u);
+    auto *c = pool.acquire();
+    ASSERT_NE(c, nullptr);
+    EXPECT_FALSE(c->is_ready());
+}
@@ -0,0 +1,130 @@
+#include "spscq_persistent.hpp"
+
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Counted
+    {
+        static inline int constructed = 0;
+        static inline int destroyed = 0;
+
+        Counted() { ++constructed; }
+        Counted(const Counted &) { ++constructed; }
+        Counted &operator=(const Counted &) = default;
+        ~Counted() { ++destroyed; }
+
+        friend void swap(Counted &a, Counted &b) noexcept { std::swap(a.value, b.value); }
+
+        int value = 0;
+    };
+}
+
+TEST(SPSCQPersistentTest, SlotsLiveForTheQueueLifetime)
+{
+    Counted::constructed = Counted::destroyed = 0;
+
+    {
+        spscq_persistent<Counted> queue(4);
+        EXPECT_EQ(Counted::constructed, 4);
+
+        Counted value;
+        for (int i = 0; i < 10; ++i)
+        {
+            EXPECT_TRUE(queue.try_fill([i](Counted &slot) { slot.value = i; }));
+            EXPECT_TRUE(queue.try_pop(value));
+            EXPECT_EQ(value.value, i);
+        }
+
+        // Neither pushing nor popping constructs or destroys anything
+        EXPECT_EQ(Counted::constructed, 5);
+        EXPECT_EQ(Counted::destroyed, 0);
+    }
+
+    EXPECT_EQ(Counted::destroyed, 5);
+}
+
+TEST(SPSCQPersistentTest, AcquireCommitAndFull)
+{
+    spscq_persistent<int> queue(3);
+
+    int *slot = queue.try_acquire();
+    ASSERT_NE(slot, nullptr);
+    *slot = 1;
+    // Not visible before commit
+    EXPECT_EQ(queue.front(), nullptr);
+    queue.commit();
+
+    EXPECT_TRUE(queue.try_push(2));
+    EXPECT_EQ(queue.try_acquire(), nullptr);
+    EXPECT_FALSE(queue.try_push(3));
+
+    ASSERT_NE(queue.front(), nullptr);
+    EXPECT_EQ(*queue.front(), 1);
+    queue.pop();
+    EXPECT_EQ(queue.size(), 1u);
+}
+
+TEST(SPSCQPersistentTest, BuffersCirculateWithoutAllocation)
+{
+    spscq_persistent<std::vector<int>> queue(4);
+    queue.prepare([](std::vector<int> &slot) { slot.reserve(64); });
+
+    std::vector<int> value;
+    value.reserve(64);
+
+    std::set<const int *> buffers;
+    for (int round = 0; round < 20; ++round)
+    {
+        EXPECT_TRUE(queue.try_fill(
+            [round](std::vector<int> &slot)
+            {
+                slot.assign(32, round);
+            }));
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, std::vector<int>(32, round));
+        buffers.insert(value.data());
+    }
+
+    // Only the 4 slot buffers and the consumer's own buffer ever circulate
+    EXPECT_LE(buffers.size(), 5u);
+}
+
+TEST(SPSCQPersistentTest, MultithreadedProducerConsumer)
+{
+    spscq_persistent<std::vector<int>> queue(8);
+    const int num_elements = 1000;
+    bool ordered = true;
+
+    std::thread producer(
+        [&]()
+        {
+            for (int i = 0; i < num_elements; ++i)
+            {
+                while (!queue.try_fill([i](std::vector<int> &slot) { slot.assign(3, i); }))
+                {
+                }
+            }
+        });
+
+    std::thread consumer(
+        [&]()
+        {
+            std::vector<int> value;
+            for (int i = 0; i < num_elements; ++i)
+            {
+                while (!queue.try_pop(value))
+                {
+                }
+                ordered = ordered && value == std::vector<int>(3, i);
+            }
+        });
+
+    producer.join();
+    consumer.join();
+
+    EXPECT_TRUE(ordered);
+}
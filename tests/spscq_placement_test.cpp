@@ -0,0 +1,115 @@
+#include "fake_sysfs.hpp"
+#include "spscq_placement.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace fs = std::filesystem;
+
+TEST(SPSCQPlacementTest, ParseCpuList)
+{
+    EXPECT_EQ(cpu_topology::parse_cpu_list("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(cpu_topology::parse_cpu_list("5"), (std::vector<int>{5}));
+    EXPECT_TRUE(cpu_topology::parse_cpu_list("").empty());
+}
+
+TEST(SPSCQPlacementTest, ReadsTopologyFromSysfs)
+{
+    const fs::path root = make_sysfs(2);
+    const cpu_topology topology = cpu_topology::from_sysfs(root.string());
+
+    ASSERT_EQ(topology.cpus().size(), 8u);
+
+    const cpu_info *cpu5 = topology.find(5);
+    ASSERT_NE(cpu5, nullptr);
+    EXPECT_EQ(cpu5->package, 1);
+    EXPECT_EQ(cpu5->node, 1);
+    EXPECT_EQ(cpu5->l2, 4);
+    EXPECT_EQ(cpu5->llc, 4);
+    EXPECT_EQ(topology.node_of_cpu(2), 0);
+
+    fs::remove_all(root);
+}
+
+TEST(SPSCQPlacementTest, ChoosesPairsByRelation)
+{
+    const fs::path root = make_sysfs(2);
+    const cpu_topology topology = cpu_topology::from_sysfs(root.string());
+
+    cpu_pair pair = choose_cpu_pair(cpu_relation::same_l2, topology);
+    EXPECT_TRUE(pair.exact);
+    EXPECT_EQ(pair.producer, 0);
+    EXPECT_EQ(pair.consumer, 1);
+
+    pair = choose_cpu_pair(cpu_relation::same_core, topology);
+    EXPECT_TRUE(pair.exact);
+    EXPECT_EQ(pair.producer, 0);
+    EXPECT_EQ(pair.consumer, 1);
+    EXPECT_TRUE(shares_core(pair, topology));
+
+    pair = choose_cpu_pair(cpu_relation::same_llc, topology);
+    EXPECT_FALSE(shares_core(pair, topology));
+    EXPECT_TRUE(pair.exact);
+    EXPECT_EQ(pair.producer, 0);
+    EXPECT_EQ(pair.consumer, 2);
+
+    pair = choose_cpu_pair(cpu_relation::cross_socket, topology);
+    EXPECT_TRUE(pair.exact);
+    EXPECT_EQ(pair.producer, 0);
+    EXPECT_EQ(pair.consumer, 4);
+
+    EXPECT_EQ(choose_cpus(4, topology), (std::vector<int>{0, 2, 4, 6}));
+    EXPECT_EQ(choose_cpus(10, topology), (std::vector<int>{0, 2, 4, 6, 1, 3, 5, 7, 0, 2}));
+
+    fs::remove_all(root);
+}
+
+TEST(SPSCQPlacementTest, FallsBackWhenRelationIsUnavailable)
+{
+    const fs::path root = make_sysfs(1);
+    const cpu_topology topology = cpu_topology::from_sysfs(root.string());
+
+    const cpu_pair pair = choose_cpu_pair(cpu_relation::cross_socket, topology);
+    EXPECT_FALSE(pair.exact);
+    EXPECT_EQ(pair.producer, 0);
+    EXPECT_EQ(pair.consumer, 2);
+
+    fs::remove_all(root);
+}
+
+TEST(SPSCQPlacementTest, LaunchesPairWithNumaQueue)
+{
+    const cpu_topology topology = cpu_topology::detect();
+    const cpu_pair cpus = choose_cpu_pair(cpu_relation::same_llc, topology);
+
+    auto queue = make_queue_for<int>(cpus, 64, topology);
+    std::atomic<int> producerCpu{-1};
+    long sum = 0;
+
+    {
+        placed_pair threads = launch_pair(
+            cpus,
+            [&]()
+            {
+                producerCpu = sched_getcpu();
+                for (int i = 0; i < 1000; ++i)
+                {
+                    queue->push(i);
+                }
+            },
+            [&]()
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    int value;
+                    queue->pop(value);
+                    sum += value;
+                }
+            });
+    }
+
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+    EXPECT_EQ(producerCpu.load(), cpus.producer);
+}
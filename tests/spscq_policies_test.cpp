@@ -0,0 +1,390 @@
+#include "spscq.hpp"
+#include "spscq_shm.hpp"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <unistd.h>
+
+TEST(SPSCQPoliciesTest, InlineStorage)
+{
+    spscq<std::string, inline_storage<std::string, 8>> queue(8);
+
+    for (int i = 0; i < 7; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(std::to_string(i)));
+    }
+    EXPECT_FALSE(queue.try_push("full"));
+
+    std::string value;
+    for (int i = 0; i < 7; ++i)
+    {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, std::to_string(i));
+    }
+    EXPECT_TRUE(queue.empty());
+
+    using small_queue = spscq<int, inline_storage<int, 4>>;
+    EXPECT_THROW(small_queue(5), std::invalid_argument);
+}
+
+TEST(SPSCQPoliciesTest, ExternalStorage)
+{
+    alignas(std::string) unsigned char buffer[4 * sizeof(std::string)];
+
+    {
+        spscq<std::string, external_storage<std::string>> queue(4, buffer);
+
+        EXPECT_TRUE(queue.try_push("a"));
+        EXPECT_TRUE(queue.try_push("b"));
+
+        std::string value;
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, "a");
+
+        // The remaining element is destroyed with the queue, the buffer is not freed
+    }
+
+    using external_queue = spscq<int, external_storage<int>>;
+    EXPECT_THROW(external_queue(4, nullptr), std::invalid_argument);
+}
+
+TEST(SPSCQPoliciesTest, SharedMemoryStorage)
+{
+    const std::string name = "/spscq_policies_test_" + std::to_string(getpid());
+
+    {
+        spscq<int, shm_storage<int>> queue(16, name.c_str());
+
+        for (int i = 0; i < 40; ++i)
+        {
+            EXPECT_TRUE(queue.try_push(i));
+            int value = -1;
+            EXPECT_TRUE(queue.try_pop(value));
+            EXPECT_EQ(value, i);
+        }
+    }
+
+    // The object is unlinked when the queue is destroyed
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    EXPECT_LT(fd, 0);
+}
+
+TEST(SPSCQPoliciesTest, SharedMemoryStorageRejectsExistingName)
+{
+    const std::string name = "/spscq_policies_test_existing_" + std::to_string(getpid());
+    spscq<int, shm_storage<int>> queue(16, name.c_str());
+    EXPECT_TRUE(queue.try_push(42));
+
+    try
+    {
+        spscq<int, shm_storage<int>> other(16, name.c_str());
+        ADD_FAILURE() << "a second queue opened an existing object";
+    }
+    catch (const std::system_error &e)
+    {
+        EXPECT_EQ(e.code(), std::errc::file_exists);
+    }
+
+    // The first queue keeps its buffer and its name
+    int value = 0;
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, 42);
+
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    EXPECT_GE(fd, 0);
+    close(fd);
+}
+
+TEST(SPSCQPoliciesTest, MaskIndexing)
+{
+    using masked_queue = spscq<int, std::allocator<int>, mask_indexing>;
+
+    EXPECT_THROW(masked_queue(6), std::invalid_argument);
+
+    masked_queue queue(4);
+    for (int round = 0; round < 5; ++round)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_TRUE(queue.try_push(round * 3 + i));
+        }
+        EXPECT_FALSE(queue.try_push(-1));
+        EXPECT_EQ(queue.size(), 3u);
+
+        int values[3];
+        EXPECT_EQ(queue.try_pop_n(values, 3), 3u);
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(values[i], round * 3 + i);
+        }
+    }
+}
+
+TEST(SPSCQPoliciesTest, BatchedPublication)
+{
+    spscq<int, std::allocator<int>, wrap_indexing, batched_publication<4>> queue(16);
+
+    int value;
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+
+    // The fourth push completes the batch
+    EXPECT_TRUE(queue.try_push(3));
+    EXPECT_EQ(queue.size(), 4u);
+
+    EXPECT_TRUE(queue.try_push(4));
+    EXPECT_EQ(queue.size(), 4u);
+    queue.flush();
+    EXPECT_EQ(queue.size(), 5u);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(SPSCQPoliciesTest, BatchedPublicationPublishesWhenFull)
+{
+    spscq<int, std::allocator<int>, wrap_indexing, batched_publication<64>> queue(4);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_EQ(queue.size(), 0u);
+
+    EXPECT_FALSE(queue.try_push(3));
+    EXPECT_EQ(queue.size(), 3u);
+}
+
+TEST(SPSCQPoliciesTest, BatchedPublicationWithBulkPush)
+{
+    spscq<int, std::allocator<int>, wrap_indexing, batched_publication<4>> queue(16);
+
+    EXPECT_TRUE(queue.try_push(1));
+    queue.flush();
+    const int values[] = {2, 3, 4};
+    EXPECT_EQ(queue.try_push_n(values, 3), 3u);
+    EXPECT_TRUE(queue.try_push(5));
+    queue.flush();
+    EXPECT_EQ(queue.size(), 5u);
+
+    // A bulk push publishes pending single pushes before its own elements
+    EXPECT_TRUE(queue.try_push(6));
+    EXPECT_EQ(queue.try_push_n(values, 1), 1u);
+    EXPECT_EQ(queue.size(), 7u);
+
+    int value;
+    for (int expected : {1, 2, 3, 4, 5, 6, 2})
+    {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(SPSCQPoliciesTest, BatchedPublicationBulkPushDestroysElements)
+{
+    auto counter = std::make_shared<int>(0);
+
+    {
+        spscq<std::shared_ptr<int>, std::allocator<std::shared_ptr<int>>, wrap_indexing, batched_publication<8>> queue(16);
+        const std::shared_ptr<int> values[] = {counter, counter};
+        EXPECT_EQ(queue.try_push_n(values, 2), 2u);
+        EXPECT_TRUE(queue.try_push(counter));
+        EXPECT_EQ(counter.use_count(), 6);
+    }
+
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SPSCQPoliciesTest, BatchedPublicationDestroysPendingElements)
+{
+    auto counter = std::make_shared<int>(0);
+
+    {
+        spscq<std::shared_ptr<int>, std::allocator<std::shared_ptr<int>>, wrap_indexing, batched_publication<8>> queue(16);
+        EXPECT_TRUE(queue.try_push(counter));
+        EXPECT_TRUE(queue.try_push(counter));
+        EXPECT_EQ(counter.use_count(), 3);
+    }
+
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SPSCQPoliciesTest, CountingStats)
+{
+    spscq<int, std::allocator<int>, wrap_indexing, eager_publication, spin_wait, counting_stats> queue(4);
+
+    int value;
+    EXPECT_FALSE(queue.try_pop(value));
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(3));
+    EXPECT_TRUE(queue.try_pop(value));
+
+    int values[4];
+    EXPECT_EQ(queue.try_pop_n(values, 4), 2u);
+
+    EXPECT_EQ(queue.producer_stats().pushes(), 3u);
+    EXPECT_EQ(queue.producer_stats().full(), 1u);
+    EXPECT_EQ(queue.consumer_stats().pops(), 3u);
+    EXPECT_EQ(queue.consumer_stats().empty(), 1u);
+}
+
+TEST(SPSCQPoliciesTest, BlockingPushPop)
+{
+    const int count = 10000;
+    spscq<int, std::allocator<int>, mask_indexing, batched_publication<16>, yield_wait<64>, counting_stats> queue(8);
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i)
+        {
+            queue.push(i);
+        }
+        queue.flush();
+    });
+
+    for (int i = 0; i < count; ++i)
+    {
+        int value = -1;
+        queue.pop(value);
+        ASSERT_EQ(value, i);
+    }
+
+    producer.join();
+
+    EXPECT_EQ(queue.producer_stats().pushes(), static_cast<uint64_t>(count));
+    EXPECT_EQ(queue.consumer_stats().pops(), static_cast<uint64_t>(count));
+}
+
+namespace
+{
+    /** Clock that only moves when a test advances it, so learned budgets are exact. */
+    struct manual_clock
+    {
+        using duration = std::chrono::nanoseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<manual_clock>;
+        static constexpr bool is_steady = true;
+
+        static time_point now() noexcept { return time_point(elapsed); }
+
+        static inline duration elapsed{0};
+    };
+
+    using manual_adaptive_wait = adaptive_wait<50, 8, manual_clock>;
+
+    /**
+     * Waits on `policy` for `duration` of manual_clock time, as a blocking operation
+     * would: one failed attempt when the wait starts and one when the element arrives.
+     */
+    void simulate_wait(manual_adaptive_wait &policy, std::chrono::nanoseconds duration)
+    {
+        policy.wait();
+        manual_clock::elapsed += duration;
+        policy.wait();
+        policy.reset();
+    }
+}
+
+TEST(SPSCQPoliciesTest, AdaptiveWaitShrinksBudgetToDenseArrivals)
+{
+    manual_adaptive_wait policy;
+    EXPECT_EQ(policy.budget_ns(), 50'000u);
+
+    for (int i = 0; i < 64; ++i)
+    {
+        simulate_wait(policy, std::chrono::microseconds(2));
+    }
+
+    // 2 us waits fall in the [1024, 2048) ns bucket, whose upper bound covers them all
+    EXPECT_EQ(policy.budget_ns(), 2'048u);
+    EXPECT_EQ(policy.waits(), 64u);
+    EXPECT_EQ(policy.sleeps(), 0u);
+}
+
+TEST(SPSCQPoliciesTest, AdaptiveWaitSleepsAtOnceForSparseArrivals)
+{
+    manual_adaptive_wait policy;
+
+    for (int i = 0; i < 32; ++i)
+    {
+        simulate_wait(policy, std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(policy.budget_ns(), 0u);
+    EXPECT_GT(policy.sleeps(), 0u);
+
+    // Dense traffic again: the probes see it and the budget grows back
+    for (int i = 0; i < 64; ++i)
+    {
+        simulate_wait(policy, std::chrono::microseconds(5));
+    }
+
+    EXPECT_GE(policy.budget_ns(), 4'096u);
+}
+
+TEST(SPSCQPoliciesTest, AdaptiveWaitThroughQueue)
+{
+    const int count = 10000;
+    spscq<int, std::allocator<int>, wrap_indexing, eager_publication, adaptive_wait<>> queue(8);
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i)
+        {
+            queue.push(i);
+        }
+    });
+
+    for (int i = 0; i < count; ++i)
+    {
+        int value = -1;
+        queue.pop(value);
+        ASSERT_EQ(value, i);
+    }
+
+    producer.join();
+
+    // The budget never exceeds the largest candidate below the 200 us probe
+    EXPECT_LE(queue.consumer_wait().budget_ns(), 131'072u);
+}
+
+TEST(SPSCQPoliciesTest, DenseLayoutWithSmtWait)
+{
+    using dense_queue = spscq<int, std::allocator<int>, wrap_indexing, eager_publication, smt_wait<>, no_stats, dense_layout>;
+    static_assert(sizeof(dense_queue) < sizeof(spscq<int>));
+    static_assert(sizeof(dense_queue) <= 128);
+
+    // Large enough that the producer never waits, as spinning waits are slow on a single CPU
+    const int count = 1000;
+    dense_queue queue(1024);
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i)
+        {
+            queue.push(i);
+        }
+    });
+
+    for (int i = 0; i < count; ++i)
+    {
+        int value = -1;
+        queue.pop(value);
+        ASSERT_EQ(value, i);
+    }
+
+    producer.join();
+}
@@ -0,0 +1,98 @@
+#include "fake_sysfs.hpp"
+#include "spscq_relay.hpp"
+
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+TEST(SPSCQRelayTest, RelayCpuIsOnConsumerNode)
+{
+    const cpu_topology topology = cpu_topology::detect();
+    const cpu_pair cpus = choose_cpu_pair(cpu_relation::cross_socket, topology);
+
+    const int relay = choose_relay_cpu(cpus, topology);
+    EXPECT_EQ(topology.node_of_cpu(relay), topology.node_of_cpu(cpus.consumer));
+    if (topology.cpus().size() > 2)
+    {
+        EXPECT_NE(relay, cpus.producer);
+    }
+}
+
+TEST(SPSCQRelayTest, RelayCpuAvoidsBothEndpointCores)
+{
+    const std::filesystem::path root = make_sysfs(2);
+    const cpu_topology topology = cpu_topology::from_sysfs(root.string());
+
+    // Cross-socket: a free core on the consumer's package
+    EXPECT_EQ(choose_relay_cpu(cpu_pair{0, 4, true}, topology), 6);
+
+    // Siblings: the package's other core
+    EXPECT_EQ(choose_relay_cpu(cpu_pair{0, 1, true}, topology), 2);
+
+    // Both cores of the package are taken: the consumer's sibling, not the producer's
+    EXPECT_EQ(choose_relay_cpu(cpu_pair{0, 2, true}, topology), 3);
+    EXPECT_EQ(choose_relay_cpu(cpu_pair{2, 0, true}, topology), 1);
+
+    std::filesystem::remove_all(root);
+}
+
+TEST(SPSCQRelayTest, RelaysInOrder)
+{
+    const cpu_pair cpus = choose_cpu_pair(cpu_relation::cross_socket);
+    const int count = 10000;
+    long sum = 0;
+    bool ordered = true;
+
+    spscq_relay<int, yield_wait<>> relay(cpus, 64, 16);
+    auto &in = relay.producer_queue();
+    auto &out = relay.consumer_queue();
+
+    {
+        placed_pair threads = launch_pair(
+            cpus,
+            [&]()
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    while (!in.try_push(i))
+                        std::this_thread::yield();
+                }
+            },
+            [&]()
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    int value;
+                    while (!out.try_pop(value))
+                        std::this_thread::yield();
+                    ordered &= value == i;
+                    sum += value;
+                }
+            });
+    }
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(sum, static_cast<long>(count - 1) * count / 2);
+    // The relay counts a batch after pushing it, possibly after the consumer popped it
+    while (relay.messages() != static_cast<uint64_t>(count))
+        std::this_thread::yield();
+    EXPECT_GE(relay.batches(), static_cast<uint64_t>(count / 16));
+}
+
+TEST(SPSCQRelayTest, RelaysNonTrivialElements)
+{
+    spscq_relay<std::string, yield_wait<>> relay(choose_cpu_pair(cpu_relation::cross_socket), 16);
+
+    relay.producer_queue().try_push("a long enough string to live on the heap");
+    relay.producer_queue().try_push("b");
+
+    std::string value;
+    while (!relay.consumer_queue().try_pop(value))
+        std::this_thread::yield();
+    EXPECT_EQ(value, "a long enough string to live on the heap");
+
+    while (!relay.consumer_queue().try_pop(value))
+        std::this_thread::yield();
+    EXPECT_EQ(value, "b");
+}
@@ -0,0 +1,165 @@
+#include "spscq_soa.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+TEST(SPSCQSoATest, PushAndPopRecords)
+{
+    spscq_soa<int, double, std::string> queue(3);
+    int id;
+    double price;
+    std::string symbol;
+
+    EXPECT_EQ(queue.capacity(), 4u);
+    EXPECT_TRUE(queue.try_push(1, 10.5, "AAPL"));
+    EXPECT_TRUE(queue.try_push(2, 20.5, "MSFT"));
+
+    EXPECT_TRUE(queue.try_pop(id, price, symbol));
+    EXPECT_EQ(id, 1);
+    EXPECT_EQ(price, 10.5);
+    EXPECT_EQ(symbol, "AAPL");
+    EXPECT_EQ(queue.size(), 1u);
+}
+
+TEST(SPSCQSoATest, FullQueue)
+{
+    spscq_soa<int, int> queue(2);
+
+    EXPECT_TRUE(queue.try_push(1, 1));
+    EXPECT_TRUE(queue.try_push(2, 2));
+    EXPECT_FALSE(queue.try_push(3, 3));
+}
+
+TEST(SPSCQSoATest, ColumnWindowsSplitAtTheWrap)
+{
+    spscq_soa<int, double> queue(8);
+
+    for (int i = 0; i < 6; ++i)
+    {
+        queue.try_push(i, i * 1.5);
+    }
+    queue.commit_read(queue.read_window(6).size());
+
+    for (int i = 0; i < 5; ++i)
+    {
+        queue.try_push(i, i * 1.5);
+    }
+
+    auto window = queue.read_window();
+    ASSERT_EQ(window.size(), 5u);
+
+    // Only the double column is read
+    auto prices = window.column<1>();
+    EXPECT_EQ(prices.firstSize, 2u);
+    EXPECT_EQ(prices.secondSize, 3u);
+
+    double total = 0;
+    for (size_t i = 0; i < prices.firstSize; ++i)
+    {
+        total += prices.first[i];
+    }
+    for (size_t i = 0; i < prices.secondSize; ++i)
+    {
+        total += prices.second[i];
+    }
+    EXPECT_EQ(total, 15.0);
+    EXPECT_EQ(window.column<0>()[4], 4);
+
+    queue.commit_read(window.size());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQSoATest, DestroysRemainingRecords)
+{
+    auto counter = std::make_shared<int>(0);
+
+    {
+        spscq_soa<int, std::shared_ptr<int>> queue(4);
+        queue.try_push(1, counter);
+        queue.try_push(2, counter);
+        queue.commit_read(queue.read_window(1).size());
+        EXPECT_EQ(counter.use_count(), 2);
+    }
+
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+namespace
+{
+    /** Field whose constructor throws on request */
+    struct throwing_field
+    {
+        int value = 0;
+
+        throwing_field() = default;
+        throwing_field(int v) : value(v)
+        {
+            if (v < 0)
+            {
+                throw std::runtime_error("negative");
+            }
+        }
+    };
+}
+
+TEST(SPSCQSoATest, ThrowingFieldLeavesQueueUnchanged)
+{
+    auto counter = std::make_shared<int>(0);
+    spscq_soa<std::shared_ptr<int>, throwing_field> queue(2);
+
+    EXPECT_THROW(queue.try_push(counter, -1), std::runtime_error);
+    EXPECT_EQ(counter.use_count(), 1);
+    EXPECT_TRUE(queue.empty());
+
+    EXPECT_TRUE(queue.try_push(counter, 7));
+    EXPECT_EQ(counter.use_count(), 2);
+
+    std::shared_ptr<int> pointer;
+    throwing_field field;
+    EXPECT_TRUE(queue.try_pop(pointer, field));
+    EXPECT_EQ(pointer, counter);
+    EXPECT_EQ(field.value, 7);
+}
+
+TEST(SPSCQSoATest, MultithreadedColumns)
+{
+    spscq_soa<long, long> queue(16);
+    const long num_elements = 10000;
+    long sum = 0;
+
+    std::thread producer(
+        [&]()
+        {
+            for (long i = 0; i < num_elements; ++i)
+            {
+                while (!queue.try_push(i, i * 2))
+                {
+                }
+            }
+        });
+
+    std::thread consumer(
+        [&]()
+        {
+            long consumed = 0;
+            while (consumed < num_elements)
+            {
+                auto window = queue.read_window();
+                auto doubled = window.column<1>();
+                for (size_t i = 0; i < doubled.size(); ++i)
+                {
+                    sum += doubled[i];
+                }
+                consumed += static_cast<long>(window.size());
+                queue.commit_read(window.size());
+            }
+        });
+
+    producer.join();
+    consumer.join();
+
+    EXPECT_EQ(sum, num_elements * (num_elements - 1));
+}
@@ -1,5 +1,7 @@
 #include "spscq.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <gtest/gtest.h>
 #include <thread>
 #include <vector>
@@ -124,3 +126,319 @@ TEST(SPSCQTest, MultithreadedProducerConsumer)
 
     EXPECT_EQ(produced_values, consumed_values);
 }
+
+TEST(SPSCQTest, FrontAndPop)
+{
+    spscq<std::string> queue(4);
+
+    EXPECT_EQ(queue.front(), nullptr);
+
+    queue.try_push("hello");
+    queue.try_push("world");
+
+    ASSERT_NE(queue.front(), nullptr);
+    EXPECT_EQ(*queue.front(), "hello");
+    queue.pop();
+    ASSERT_NE(queue.front(), nullptr);
+    EXPECT_EQ(*queue.front(), "world");
+    queue.pop();
+    EXPECT_EQ(queue.front(), nullptr);
+}
+
+TEST(SPSCQTest, BulkPushPop)
+{
+    spscq<int> queue(8);
+    const int input[] = {1, 2, 3, 4, 5};
+    int output[8];
+
+    EXPECT_EQ(queue.try_push_n(input, 5), 5u);
+    // Only two free slots remain
+    EXPECT_EQ(queue.try_push_n(input, 5), 2u);
+    EXPECT_EQ(queue.size(), 7u);
+
+    EXPECT_EQ(queue.try_pop_n(output, 3), 3u);
+    EXPECT_EQ(output[0], 1);
+    EXPECT_EQ(output[2], 3);
+
+    // Wraps around the end of the buffer
+    EXPECT_EQ(queue.try_push_n(input, 3), 3u);
+    EXPECT_EQ(queue.try_pop_n(output, 8), 7u);
+    EXPECT_EQ(output[0], 4);
+    EXPECT_EQ(output[1], 5);
+    EXPECT_EQ(output[2], 1);
+    EXPECT_EQ(output[3], 2);
+    EXPECT_EQ(output[6], 3);
+    EXPECT_EQ(queue.try_pop_n(output, 8), 0u);
+}
+
+TEST(SPSCQTest, DeferredPopDestroysOnReclaim)
+{
+    auto counter = std::make_shared<int>(0);
+    spscq<std::shared_ptr<int>> queue(64);
+    std::shared_ptr<int> value;
+
+    queue.try_push(counter);
+    queue.try_push(counter);
+    queue.try_push(counter);
+
+    EXPECT_TRUE(queue.try_pop_deferred(value));
+    EXPECT_TRUE(queue.try_pop_deferred(value));
+    EXPECT_EQ(value, counter);
+    value.reset();
+
+    // The moved-from slots are neither destroyed nor released yet
+    EXPECT_EQ(queue.size(), 3u);
+
+    queue.reclaim();
+    EXPECT_EQ(queue.size(), 1u);
+
+    // Mixing with try_pop is safe after a reclaim
+    EXPECT_TRUE(queue.try_pop_deferred(value));
+    queue.reclaim();
+    EXPECT_FALSE(queue.try_pop(value));
+    EXPECT_TRUE(queue.empty());
+    value.reset();
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SPSCQTest, DeferredPopReclaimsWhenIdleOrNearlyFull)
+{
+    spscq<int> queue(64);
+    int value;
+
+    for (int i = 0; i < 40; ++i)
+    {
+        queue.try_push(i);
+    }
+
+    // With plenty of free slots, deferred pops destroy nothing
+    for (int i = 0; i < 40; ++i)
+    {
+        EXPECT_TRUE(queue.try_pop_deferred(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_EQ(queue.size(), 40u);
+
+    for (int i = 40; i < 60; ++i)
+    {
+        queue.try_push(i);
+    }
+
+    // Fewer than 16 of the 63 slots are free: one pop releases a chunk of 16 slots
+    EXPECT_TRUE(queue.try_pop_deferred(value));
+    EXPECT_EQ(value, 40);
+    EXPECT_EQ(queue.size(), 44u);
+
+    for (int i = 41; i < 60; ++i)
+    {
+        EXPECT_TRUE(queue.try_pop_deferred(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_EQ(queue.size(), 44u);
+
+    // Finding the queue empty reclaims everything
+    EXPECT_FALSE(queue.try_pop_deferred(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQTest, BackInserterCopiesRange)
+{
+    spscq<int> queue(16);
+    std::vector<int> input{1, 2, 3, 4, 5};
+    int value;
+
+    std::copy(input.begin(), input.end(), queue.back_inserter(2));
+
+    EXPECT_EQ(queue.size(), input.size());
+    for (int expected : input)
+    {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(SPSCQTest, BackInserterPublishesOnDestruction)
+{
+    spscq<int> queue(16);
+
+    {
+        auto out = queue.back_inserter();
+        *out++ = 1;
+        *out++ = 2;
+        // Below the batch size, nothing is published yet
+        EXPECT_TRUE(queue.empty());
+    }
+
+    EXPECT_EQ(queue.size(), 2u);
+}
+
+TEST(SPSCQTest, DrainIteratesAvailableElements)
+{
+    spscq<std::string> queue(4);
+    std::vector<std::string> drained;
+
+    queue.try_push("a");
+    queue.try_push("b");
+    queue.try_push("c");
+
+    for (auto &value : queue.drain())
+    {
+        drained.push_back(std::move(value));
+    }
+
+    EXPECT_EQ(drained, (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_TRUE(queue.empty());
+    // The released slots are available to the producer again
+    EXPECT_TRUE(queue.try_push("d"));
+}
+
+TEST(SPSCQTest, DrainStopsEarly)
+{
+    spscq<int> queue(8);
+    int value;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        queue.try_push(i);
+    }
+
+    {
+        auto range = queue.drain(3);
+        EXPECT_EQ(range.size(), 3u);
+        for (auto &x : range)
+        {
+            if (x == 1)
+            {
+                break;
+            }
+        }
+    }
+
+    EXPECT_EQ(queue.size(), 4u);
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, 1);
+}
+
+TEST(SPSCQTest, MultithreadedBackInserterDrain)
+{
+    spscq<int> queue(16);
+    const int num_elements = 1000;
+
+    std::vector<int> produced_values(num_elements);
+    std::vector<int> consumed_values;
+
+    for (int i = 0; i < num_elements; ++i)
+    {
+        produced_values[i] = i;
+    }
+
+    std::thread producer(
+        [&]()
+        {
+            std::copy(produced_values.begin(), produced_values.end(), queue.back_inserter(4));
+        });
+
+    std::thread consumer(
+        [&]()
+        {
+            while (consumed_values.size() < static_cast<size_t>(num_elements))
+            {
+                for (int value : queue.drain())
+                {
+                    consumed_values.push_back(value);
+                }
+            }
+        });
+
+    producer.join();
+    consumer.join();
+
+    EXPECT_EQ(produced_values, consumed_values);
+}
+
+TEST(SPSCQTest, GatherReturnsWhenBatchIsFull)
+{
+    spscq<int> queue(16);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        queue.try_push(i);
+    }
+
+    // A far deadline is never reached: enough elements are already available
+    std::vector<int> batch{42};
+    EXPECT_EQ(queue.gather(batch, 4, std::chrono::steady_clock::now() + std::chrono::hours(1)), 4u);
+    EXPECT_EQ(batch, (std::vector<int>{0, 1, 2, 3}));
+
+    auto range = queue.gather(4, std::chrono::steady_clock::now() + std::chrono::hours(1));
+    EXPECT_EQ(range.size(), 4u);
+    EXPECT_EQ(*range.begin(), 4);
+}
+
+TEST(SPSCQTest, GatherReturnsPartialBatchAtDeadline)
+{
+    spscq<int, std::allocator<int>, wrap_indexing, eager_publication, sleep_wait<>> queue(16);
+    std::vector<int> batch;
+
+    queue.try_push(1);
+    queue.try_push(2);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(queue.gather(batch, 500, start + std::chrono::milliseconds(2)), 2u);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2));
+    EXPECT_EQ(batch, (std::vector<int>{1, 2}));
+
+    EXPECT_EQ(queue.gather(batch, 500, std::chrono::steady_clock::now()), 0u);
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST(SPSCQTest, GatherReturnsWhenQueueIsFull)
+{
+    spscq<int, std::allocator<int>, wrap_indexing, eager_publication, sleep_wait<>> queue(8);
+    EXPECT_EQ(queue.capacity(), 7u);
+
+    for (int i = 0; i < 7; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+
+    // More than the queue can hold: the wait ends once it is full
+    std::vector<int> batch;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(queue.gather(batch, 500, start + std::chrono::hours(1)), 7u);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+    EXPECT_EQ(batch, (std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST(SPSCQTest, MultithreadedGather)
+{
+    spscq<int, std::allocator<int>, wrap_indexing, eager_publication, sleep_wait<>> queue(64);
+    const int num_elements = 10000;
+    std::vector<int> consumed_values;
+
+    std::thread producer(
+        [&]()
+        {
+            for (int i = 0; i < num_elements; ++i)
+            {
+                while (!queue.try_push(i))
+                    ;
+            }
+        });
+
+    std::vector<int> batch;
+    while (consumed_values.size() < static_cast<size_t>(num_elements))
+    {
+        queue.gather(batch, 32, std::chrono::steady_clock::now() + std::chrono::milliseconds(1));
+        EXPECT_LE(batch.size(), 32u);
+        consumed_values.insert(consumed_values.end(), batch.begin(), batch.end());
+    }
+
+    producer.join();
+
+    for (int i = 0; i < num_elements; ++i)
+    {
+        ASSERT_EQ(consumed_values[i], i);
+    }
+}